@@ -407,7 +407,9 @@ namespace IGC
 
                     GetDebugFlag(DebugFlag::VISA_DUMPCOMMONISA) ||
 
-                    IGC_IS_FLAG_ENABLED(EnableCapsDump))
+                    IGC_IS_FLAG_ENABLED(EnableCapsDump) ||
+
+                    IGC_IS_FLAG_ENABLED(DumpCompileTimeTrace))
 
                 {
 
@@ -581,7 +583,8 @@ namespace IGC
                     GetDebugFlag(DebugFlag::VISA_OUTPUT) ||
                     GetDebugFlag(DebugFlag::VISA_BINARY) ||
                     GetDebugFlag(DebugFlag::VISA_DUMPCOMMONISA) ||
-                    IGC_IS_FLAG_ENABLED(EnableCapsDump))
+                    IGC_IS_FLAG_ENABLED(EnableCapsDump) ||
+                    IGC_IS_FLAG_ENABLED(DumpCompileTimeTrace))
                 {
                     needMkdir = true;
                 }
@@ -34,5 +34,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #define OCL_BC_RS_COMMON                123
 #define OCL_BC_RS_V1                    124
 #define OCL_BC_RS_V2                    125
-#define OCL_BC_END                      125
+#define OCL_BC_INDEX_32                 126
+#define OCL_BC_INDEX_64                 127
+#define OCL_BC_END                      127
 
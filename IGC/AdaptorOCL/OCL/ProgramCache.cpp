@@ -0,0 +1,465 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+#include "AdaptorOCL/OCL/ProgramCache.h"
+#include "Compiler/CISACodeGen/Platform.hpp"
+#include "common/igc_regkeys.hpp"
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/Support/Chrono.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MD5.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/Process.h>
+#include <llvm/Support/raw_ostream.h>
+#include "common/LLVMWarningsPop.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#ifdef LLVM_ON_UNIX
+#include <dlfcn.h>
+#endif
+#ifdef LLVM_ON_WIN32
+#include <Windows.h>
+// Windows.h defines MemoryFence as _mm_mfence, but this conflicts with llvm::sys::MemoryFence
+#undef MemoryFence
+#endif
+
+using namespace llvm;
+
+namespace TC
+{
+
+static const char g_cacheMagic[] = "IGCPC001";
+static const size_t g_cacheMagicSize = sizeof(g_cacheMagic) - 1;
+static const size_t g_cacheKeySize = 32;
+static const uint64_t g_defaultCacheMaxSizeMB = 256;
+
+struct SProgramCacheHeader
+{
+    char     magic[g_cacheMagicSize];
+    char     key[g_cacheKeySize];
+    uint32_t outputSize;
+    uint32_t debugDataSize;
+};
+
+static void HashBytes(MD5& hash, const void* pData, size_t size)
+{
+    if (pData != nullptr && size != 0)
+    {
+        hash.update(ArrayRef<uint8_t>(static_cast<const uint8_t*>(pData), size));
+    }
+}
+
+// Only scalars are hashed by value; structs are hashed field by field so that
+// padding bytes never end up in the key.
+template <typename T>
+static void HashValue(MD5& hash, const T& value)
+{
+    static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value,
+        "hash the fields of aggregate types explicitly");
+    HashBytes(hash, &value, sizeof(value));
+}
+
+static void HashPlatform(MD5& hash, const PLATFORM& platform)
+{
+    HashValue(hash, platform.eProductFamily);
+    HashValue(hash, platform.ePCHProductFamily);
+    HashValue(hash, platform.eDisplayCoreFamily);
+    HashValue(hash, platform.eRenderCoreFamily);
+#ifndef _COMMON_PPA
+    HashValue(hash, platform.ePlatformType);
+#endif
+    HashValue(hash, platform.usDeviceID);
+    HashValue(hash, platform.usRevId);
+    HashValue(hash, platform.usDeviceID_PCH);
+    HashValue(hash, platform.usRevId_PCH);
+    HashValue(hash, platform.eGTType);
+}
+
+// The OCL entry points only fill in the features copied by ConvertSkuTable, and
+// the workaround table and compiler caps are derived from them and the platform.
+static void HashSkuTable(MD5& hash, const SKU_FEATURE_TABLE& skuTable)
+{
+    const unsigned int features[] =
+    {
+        skuTable.FtrDesktop,
+        skuTable.FtrGtBigDie,
+        skuTable.FtrGtMediumDie,
+        skuTable.FtrGtSmallDie,
+        skuTable.FtrGT1,
+        skuTable.FtrGT1_5,
+        skuTable.FtrGT2,
+        skuTable.FtrGT3,
+        skuTable.FtrGT4,
+        skuTable.FtrIVBM0M1Platform,
+        skuTable.FtrSGTPVSKUStrapPresent,
+        skuTable.FtrGTA,
+        skuTable.FtrGTC,
+        skuTable.FtrGTX,
+        skuTable.Ftr5Slice,
+        skuTable.FtrGpGpuMidThreadLevelPreempt,
+        skuTable.FtrIoMmuPageFaulting,
+        skuTable.FtrWddm2Svm,
+        skuTable.FtrPooledEuEnabled,
+    };
+    for (unsigned int feature : features)
+    {
+        HashValue(hash, (uint8_t)feature);
+    }
+}
+
+// Fields copied from SUscGTSystemInfo by CPlatform::SetGTSystemInfo.
+static void HashGTSystemInfo(MD5& hash, const GT_SYSTEM_INFO& gtSystemInfo)
+{
+    HashValue(hash, gtSystemInfo.EUCount);
+    HashValue(hash, gtSystemInfo.ThreadCount);
+    HashValue(hash, gtSystemInfo.SliceCount);
+    HashValue(hash, gtSystemInfo.SubSliceCount);
+    HashValue(hash, gtSystemInfo.TotalPsThreadsWindowerRange);
+    HashValue(hash, gtSystemInfo.TotalVsThreads);
+    HashValue(hash, gtSystemInfo.TotalDsThreads);
+    HashValue(hash, gtSystemInfo.TotalGsThreads);
+    HashValue(hash, gtSystemInfo.TotalHsThreads);
+    HashValue(hash, gtSystemInfo.MaxEuPerSubSlice);
+    HashValue(hash, gtSystemInfo.EuCountPerPoolMax);
+    HashValue(hash, gtSystemInfo.EuCountPerPoolMin);
+    HashValue(hash, gtSystemInfo.MaxSlicesSupported);
+    HashValue(hash, gtSystemInfo.MaxSubSlicesSupported);
+    HashValue(hash, (uint8_t)gtSystemInfo.IsDynamicallyPopulated);
+    HashValue(hash, gtSystemInfo.CsrSizeInMb);
+}
+
+// Returns the path of the binary this code is linked into, or an empty string.
+static std::string GetLibraryPath()
+{
+#if defined(LLVM_ON_UNIX)
+    Dl_info info;
+    if (dladdr((void*)&GetLibraryPath, &info) != 0 && info.dli_fname != nullptr)
+    {
+        return info.dli_fname;
+    }
+#elif defined(LLVM_ON_WIN32)
+    HMODULE hMod = NULL;
+    char path[MAX_PATH];
+    if (GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS |
+            GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+            (LPCSTR)&GetLibraryPath,
+            &hMod))
+    {
+        DWORD length = GetModuleFileNameA(hMod, path, sizeof(path));
+        if (length != 0 && length < sizeof(path))
+        {
+            return std::string(path, length);
+        }
+    }
+#endif
+    return std::string();
+}
+
+// Tells builds of the compiler apart: the build id from the build system when there is
+// one, and the size and time stamp of the IGC binary, which change with every rebuild
+// or upgrade. Empty if neither is available.
+static const std::string& GetBuildId()
+{
+    static const std::string buildId = []()
+    {
+        std::string id;
+#ifdef TB_BUILD_ID
+        id += std::to_string((uint32_t)TB_BUILD_ID) + ";";
+#endif
+        std::string path = GetLibraryPath();
+        sys::fs::file_status status;
+        if (!path.empty() && !sys::fs::status(path, status))
+        {
+            id += path + ";" + std::to_string(status.getSize()) + ";" +
+                std::to_string(status.getLastModificationTime().time_since_epoch().count());
+        }
+        return id;
+    }();
+    return buildId;
+}
+
+// The cache directory was set, so say once per process why it is not used.
+static void WarnCacheDisabled(const char* pReason)
+{
+    static std::atomic<bool> warned(false);
+    if (!warned.exchange(true))
+    {
+        errs() << "warning: IGC_OCLProgramCacheDir is set, but the program cache is disabled: "
+            << pReason << "\n";
+    }
+}
+
+ProgramCache::ProgramCache(
+    const STB_TranslateInputArgs* pInputArgs,
+    const IGC::CPlatform& platform,
+    float profilingTimerResolution)
+{
+    const char* pDirectory = getenv("IGC_OCLProgramCacheDir");
+    if (pDirectory == nullptr || pDirectory[0] == '\0')
+    {
+        return;
+    }
+
+    // Without a build id there is nothing that tells two builds of the compiler
+    // apart, so a stale entry could be returned after an upgrade.
+    const std::string& buildId = GetBuildId();
+    if (buildId.empty())
+    {
+        WarnCacheDisabled("the location of the IGC binary could not be determined");
+        return;
+    }
+
+    // GTPin and the compile time statistics change or add to the output, and a cached
+    // build would not produce the requested dumps.
+    if (pInputArgs->GTPinInput != nullptr ||
+        pInputArgs->CompileTimeStatisticsEnable ||
+        IGC_IS_FLAG_ENABLED(ShaderDumpEnable) ||
+        IGC_IS_FLAG_ENABLED(ShaderOverride))
+    {
+        WarnCacheDisabled("GTPin, compile time statistics, shader dumps or shader override are enabled");
+        return;
+    }
+
+    MD5 hash;
+    hash.update(StringRef(g_cacheMagic, g_cacheMagicSize));
+    HashValue(hash, TC::STB_VERSION);
+    HashValue(hash, (uint64_t)buildId.size());
+    HashBytes(hash, buildId.data(), buildId.size());
+    HashValue(hash, pInputArgs->InputSize);
+    HashBytes(hash, pInputArgs->pInput, pInputArgs->InputSize);
+    HashValue(hash, pInputArgs->OptionsSize);
+    HashBytes(hash, pInputArgs->pOptions, pInputArgs->OptionsSize);
+    HashValue(hash, pInputArgs->InternalOptionsSize);
+    HashBytes(hash, pInputArgs->pInternalOptions, pInputArgs->InternalOptionsSize);
+    HashPlatform(hash, platform.getPlatformInfo());
+    HashSkuTable(hash, platform.getSkuTable());
+    HashGTSystemInfo(hash, platform.GetGTSystemInfo());
+    HashValue(hash, profilingTimerResolution);
+#if defined(IGC_DEBUG_VARIABLES)
+    // Regkeys can change the generated code in debug and internal builds.
+    SRegKeyVariableMetaData* pRegKeyVariable = (SRegKeyVariableMetaData*)&g_RegKeyList;
+    unsigned NUM_REGKEY_ENTRIES = sizeof(SRegKeysList) / sizeof(SRegKeyVariableMetaData);
+    for (unsigned i = 0; i < NUM_REGKEY_ENTRIES; i++)
+    {
+        // m_Value and m_string share storage; take the integer value and the
+        // string up to its terminator so unused trailing bytes stay out of the key.
+        const char* pString = pRegKeyVariable[i].m_string;
+        size_t length = strnlen(pString, sizeof(pRegKeyVariable[i].m_string));
+        HashValue(hash, pRegKeyVariable[i].m_Value);
+        HashValue(hash, (uint64_t)length);
+        HashBytes(hash, pString, length);
+    }
+#endif
+
+    MD5::MD5Result result;
+    hash.final(result);
+    SmallString<32> key;
+    MD5::stringifyResult(result, key);
+
+    SmallString<256> entryPath(pDirectory);
+    sys::path::append(entryPath, key.str() + ".bin");
+
+    m_directory = pDirectory;
+    m_entryPath = entryPath.str();
+    m_key = key.str();
+}
+
+bool ProgramCache::Load(STB_TranslateOutputArgs* pOutputArgs) const
+{
+    if (!IsEnabled())
+    {
+        return false;
+    }
+
+    ErrorOr<std::unique_ptr<MemoryBuffer>> BufferOrErr = MemoryBuffer::getFile(m_entryPath);
+    if (!BufferOrErr)
+    {
+        return false;
+    }
+
+    const MemoryBuffer& buffer = *BufferOrErr.get();
+    SProgramCacheHeader header;
+    if (buffer.getBufferSize() < sizeof(header))
+    {
+        return false;
+    }
+    memcpy(&header, buffer.getBufferStart(), sizeof(header));
+    if (memcmp(header.magic, g_cacheMagic, g_cacheMagicSize) != 0 ||
+        memcmp(header.key, m_key.data(), g_cacheKeySize) != 0 ||
+        buffer.getBufferSize() != sizeof(header) + (uint64_t)header.outputSize + header.debugDataSize ||
+        header.outputSize == 0)
+    {
+        return false;
+    }
+
+    const char* pData = buffer.getBufferStart() + sizeof(header);
+    char* pOutput = new char[header.outputSize];
+    memcpy(pOutput, pData, header.outputSize);
+    pOutputArgs->pOutput = pOutput;
+    pOutputArgs->OutputSize = header.outputSize;
+
+    if (header.debugDataSize != 0)
+    {
+        char* pDebugData = new char[header.debugDataSize];
+        memcpy(pDebugData, pData + header.outputSize, header.debugDataSize);
+        pOutputArgs->pDebugData = pDebugData;
+        pOutputArgs->DebugDataSize = header.debugDataSize;
+    }
+
+    // Mark the entry as recently used.
+    int fd = 0;
+    if (!sys::fs::openFileForWrite(m_entryPath, fd, sys::fs::F_Append))
+    {
+        sys::fs::setLastModificationAndAccessTime(fd, std::chrono::system_clock::now());
+        sys::Process::SafelyCloseFileDescriptor(fd);
+    }
+
+    return true;
+}
+
+void ProgramCache::Store(const STB_TranslateOutputArgs* pOutputArgs) const
+{
+    if (!IsEnabled() || pOutputArgs->pOutput == nullptr || pOutputArgs->OutputSize == 0)
+    {
+        return;
+    }
+
+    if (sys::fs::create_directories(m_directory))
+    {
+        return;
+    }
+
+    SProgramCacheHeader header;
+    memcpy(header.magic, g_cacheMagic, g_cacheMagicSize);
+    memcpy(header.key, m_key.data(), g_cacheKeySize);
+    header.outputSize = pOutputArgs->OutputSize;
+    header.debugDataSize = pOutputArgs->pDebugData ? pOutputArgs->DebugDataSize : 0;
+
+    // Write to a unique temporary file and rename it into place, so that other processes
+    // either see the complete entry or none at all.
+    SmallString<256> tempModel(m_directory);
+    sys::path::append(tempModel, m_key + "-%%%%%%%%.tmp");
+    SmallString<256> tempPath;
+    int fd = 0;
+    if (sys::fs::createUniqueFile(tempModel, fd, tempPath))
+    {
+        return;
+    }
+
+    bool hasError = false;
+    {
+        raw_fd_ostream os(fd, true);
+        os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        os.write(pOutputArgs->pOutput, header.outputSize);
+        if (header.debugDataSize != 0)
+        {
+            os.write(pOutputArgs->pDebugData, header.debugDataSize);
+        }
+        os.close();
+        hasError = os.has_error();
+        os.clear_error();
+    }
+
+    if (hasError || sys::fs::rename(tempPath, m_entryPath))
+    {
+        sys::fs::remove(tempPath);
+        return;
+    }
+
+    Evict();
+}
+
+void ProgramCache::Evict() const
+{
+    uint64_t maxSize = g_defaultCacheMaxSizeMB;
+    if (const char* pMaxSize = getenv("IGC_OCLProgramCacheMaxSizeMB"))
+    {
+        maxSize = strtoull(pMaxSize, nullptr, 0);
+    }
+    maxSize *= 1024 * 1024;
+
+    struct SEntry
+    {
+        std::string path;
+        uint64_t size;
+        sys::TimePoint<> lastUse;
+    };
+    std::vector<SEntry> entries;
+    uint64_t totalSize = 0;
+
+    std::error_code EC;
+    for (sys::fs::directory_iterator it(m_directory, EC), end; it != end && !EC; it.increment(EC))
+    {
+        if (sys::path::extension(it->path()) != ".bin")
+        {
+            continue;
+        }
+        sys::fs::file_status status;
+        if (it->status(status))
+        {
+            continue;
+        }
+        entries.push_back({ it->path(), status.getSize(), status.getLastModificationTime() });
+        totalSize += status.getSize();
+    }
+
+    if (totalSize <= maxSize)
+    {
+        return;
+    }
+
+    // Remove the least recently used entries until the cache is back to 3/4 of its limit,
+    // so that a full cache is not trimmed on every store.
+    std::sort(entries.begin(), entries.end(), [](const SEntry& a, const SEntry& b)
+    {
+        return a.lastUse < b.lastUse;
+    });
+    for (auto& entry : entries)
+    {
+        if (totalSize <= maxSize / 4 * 3)
+        {
+            break;
+        }
+        if (!sys::fs::remove(entry.path))
+        {
+            totalSize -= entry.size;
+        }
+    }
+}
+
+} // namespace TC
@@ -0,0 +1,78 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+#pragma once
+
+#include "AdaptorOCL/TranslationBlock.h"
+
+#include <string>
+
+namespace IGC
+{
+    class CPlatform;
+}
+
+namespace TC
+{
+/// Persistent on-disk cache of OCL program binaries.
+///
+/// The cache is opt-in: it is only used when the IGC_OCLProgramCacheDir environment
+/// variable names a directory. Entries are keyed by a hash of the input, the build and
+/// internal options, the platform description (including SKU and WA tables) and the IGC
+/// build (the size and time stamp of the IGC binary, plus the build id when the build
+/// system provides one), and hold the program binary and debug data returned by
+/// TranslateBuild. A warning is printed once if the directory is set but the cache
+/// cannot be used.
+/// Entries are written to a temporary file and renamed into place, so concurrent
+/// processes never see partial entries. When the directory grows beyond
+/// IGC_OCLProgramCacheMaxSizeMB (256 by default) the least recently used entries are
+/// removed.
+class ProgramCache
+{
+public:
+    ProgramCache(
+        const STB_TranslateInputArgs* pInputArgs,
+        const IGC::CPlatform& platform,
+        float profilingTimerResolution);
+
+    /// Returns true if the cache can be used for this build.
+    bool IsEnabled() const { return !m_entryPath.empty(); }
+
+    /// Fills pOutputArgs from the cache. Returns false on a miss.
+    bool Load(STB_TranslateOutputArgs* pOutputArgs) const;
+
+    /// Stores the successful output of a build.
+    void Store(const STB_TranslateOutputArgs* pOutputArgs) const;
+
+private:
+    void Evict() const;
+
+    std::string m_directory;
+    std::string m_entryPath;
+    std::string m_key;
+};
+
+} // namespace TC
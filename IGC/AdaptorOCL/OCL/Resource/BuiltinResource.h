@@ -32,5 +32,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #define OCL_BC_64                       121
 #define OCL_BC                          122
 #define OCL_BC_RS                       123
-#define OCL_BC_END                      124
+#define OCL_BC_INDEX_32                 126
+#define OCL_BC_INDEX_64                 127
+#define OCL_BC_END                      127
 
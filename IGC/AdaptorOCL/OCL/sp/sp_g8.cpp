@@ -2349,6 +2349,15 @@ RETVAL CGen8OpenCLStateProcessor::CombineKernelBinary(
 
     ICBE_DPF( GFXDBG_HARDWARE, "Kernel Name: %s\n", annotations.m_kernelName.c_str() );
 
+    kernelBinary.Reserve( kernelBinary.Size() +
+        sizeof( header ) +
+        header.KernelNameSize +
+        header.KernelHeapSize +
+        header.GeneralStateHeapSize +
+        header.DynamicStateHeapSize +
+        header.SurfaceStateHeapSize +
+        header.PatchListSize );
+
     kernelBinary.Write( header );
     kernelBinary.Write( annotations.m_kernelName.c_str(), annotations.m_kernelName.size() + 1 );
     kernelBinary.Align( 4 );
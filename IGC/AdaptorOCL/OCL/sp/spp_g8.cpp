@@ -87,6 +87,13 @@ RETVAL CGen8OpenCLProgram::GetProgramBinary(
         DebugProgramBinaryHeader(&header, m_StateProcessor.m_oclStateDebugMessagePrintOut);
     }
 
+    std::streamsize programBinarySize = sizeof( header ) + m_ProgramScopePatchStream->Size();
+    for( auto data : m_KernelBinaries )
+    {
+        programBinarySize += data.kernelBinary->Size();
+    }
+    programBinary.Reserve( programBinarySize );
+
     programBinary.Write( header );
 
     programBinary.Write( *m_ProgramScopePatchStream );
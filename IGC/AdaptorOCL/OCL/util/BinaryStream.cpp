@@ -26,67 +26,81 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "BinaryStream.h"
 
+#include <cstring>
+#include <new>
+
 namespace Util
 {
 
-BinaryStream::BinaryStream() : m_membuf( std::ios::in | std::ios::out | std::ios::binary )
+BinaryStream::BinaryStream() : m_buffer( nullptr ), m_size( 0 ), m_capacity( 0 )
 {
     // Nothing!
 }
 
 BinaryStream::~BinaryStream()
 {
-    // Nothing!
+    delete[] m_buffer;
 }
 
-bool BinaryStream::Write( const char* s, std::streamsize n )
+bool BinaryStream::Grow( std::streamsize minCapacity )
 {
-    bool retValue = false;
-
-    std::streamsize prevSize = Size();
+    std::streamsize newCapacity = m_capacity ? m_capacity : 256;
+    while( newCapacity < minCapacity )
+    {
+        newCapacity *= 2;
+    }
+    return Reserve( newCapacity );
+}
 
-    m_membuf.write( s, n );
+bool BinaryStream::Reserve( std::streamsize capacity )
+{
+    if( capacity <= m_capacity )
+    {
+        return true;
+    }
 
-    if( ( Size() - prevSize ) == n )
+    char* newBuffer = new (std::nothrow) char[ capacity ];
+    if( newBuffer == nullptr )
     {
-        retValue = true;
+        return false;
     }
 
-    if( m_membuf.fail() )
+    if( m_size )
     {
-        retValue = false;
+        memcpy( newBuffer, m_buffer, m_size );
     }
+    delete[] m_buffer;
 
-#if defined(_DEBUG)
-    GetLinearPointer();
-#endif
+    m_buffer = newBuffer;
+    m_capacity = capacity;
 
-    return retValue;
+    return true;
 }
 
-bool BinaryStream::Write( const BinaryStream& in )
+bool BinaryStream::Write( const char* s, std::streamsize n )
 {
-    bool retValue = false;
-
-    std::streamsize prevSize = Size();
+    if( n < 0 )
+    {
+        return false;
+    }
 
-    m_membuf << in.m_membuf.str();
-    
-    if( ( Size() - prevSize ) == in.Size() )
+    if( ( m_size + n ) > m_capacity && !Grow( m_size + n ) )
     {
-        retValue = true;
+        return false;
     }
 
-    if( m_membuf.fail() )
+    if( n )
     {
-        retValue = false;
+        memcpy( m_buffer + m_size, s, n );
+        m_size += n;
     }
 
-#if defined(_DEBUG)
-    GetLinearPointer();
-#endif
+    return true;
+}
 
-    return retValue;
+bool BinaryStream::Write( const BinaryStream& in )
+{
+    return Write( in.m_buffer, in.m_size );
 }
 
 
@@ -97,9 +111,7 @@ bool BinaryStream::WriteAt( const char* s, std::streamsize n, std::streamsize lo
     // Give this function name it seems like this function should enlarge the stream if needed. Discuss.
     if( ( n + loc ) < Size() )
     {
-        m_membuf.seekp( loc, std::ios_base::beg );
-        Write( s, n );
-        m_membuf.seekp( 0, std::ios_base::end );
+        memcpy( m_buffer + loc, s, n );
     }
     else
     {
@@ -109,10 +121,15 @@ bool BinaryStream::WriteAt( const char* s, std::streamsize n, std::streamsize lo
     return retValue;
 }
 
-const char* BinaryStream::GetLinearPointer()
+char* BinaryStream::Release()
 {
-    m_LinearPointer = m_membuf.str();
-    return m_LinearPointer.c_str();
+    char* buffer = m_buffer;
+
+    m_buffer = nullptr;
+    m_size = 0;
+    m_capacity = 0;
+
+    return buffer;
 }
 
 bool BinaryStream::Align( std::streamsize alignment )
@@ -137,28 +154,22 @@ bool BinaryStream::Align( std::streamsize alignment )
 
 bool BinaryStream::AddPadding( std::streamsize padding )
 {
-    bool retValue = true;
-
-    while( padding-- )
+    if( padding <= 0 )
     {
-        // Always pad with 0x0 to make external tools that parse
-        // OpenCL program binaries easier to maintain
-        retValue &= Write( (char)0x0 );
+        return true;
     }
 
-    return retValue;
-}
+    if( ( m_size + padding ) > m_capacity && !Grow( m_size + padding ) )
+    {
+        return false;
+    }
 
-std::streamsize BinaryStream::Size() const
-{
-    // tellp is a non const function
-    // TODO: Is there a better way to do this?
-    return const_cast<BinaryStream*>(this)->Size();
-}
+    // Always pad with 0x0 to make external tools that parse
+    // OpenCL program binaries easier to maintain
+    memset( m_buffer + m_size, 0, padding );
+    m_size += padding;
 
-std::streamsize BinaryStream::Size()
-{
-    return m_membuf.tellp();
+    return true;
 }
 
 }
@@ -26,17 +26,21 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #pragma once
 
-#include <sstream>
+#include <ios>
 
 namespace Util
 {
 
+/// Growable, contiguous byte buffer used to serialize program and kernel binaries.
 class BinaryStream
 {
 public:
     BinaryStream();
     ~BinaryStream();
 
+    BinaryStream( const BinaryStream& ) = delete;
+    BinaryStream& operator=( const BinaryStream& ) = delete;
+
     bool Write( const char* s, std::streamsize n );
 
     bool Write( const BinaryStream& in );
@@ -52,15 +56,24 @@ public:
     bool Align( std::streamsize alignment );
     bool AddPadding( std::streamsize padding );
 
-    const char* GetLinearPointer();
-    
-    std::streamsize Size() const;
-    std::streamsize Size();
+    /// Makes room for at least capacity bytes without further reallocation.
+    bool Reserve( std::streamsize capacity );
+
+    /// Returns the stream contents. The pointer is invalidated by the next write.
+    const char* GetLinearPointer() const { return m_buffer; }
+
+    /// Hands the contents over to the caller, who frees them with delete[].
+    /// The stream is left empty.
+    char* Release();
+
+    std::streamsize Size() const { return m_size; }
 
 private:
-    std::stringstream m_membuf;
+    bool Grow( std::streamsize minCapacity );
 
-    std::string m_LinearPointer;
+    char*           m_buffer;
+    std::streamsize m_size;
+    std::streamsize m_capacity;
 };
 
 template< class T >
@@ -162,7 +162,8 @@ namespace IGC
 static void CommonOCLBasedPasses(
     OpenCLProgramContext* pContext,
     std::unique_ptr<llvm::Module> BuiltinGenericModule,
-    std::unique_ptr<llvm::Module> BuiltinSizeModule)
+    std::unique_ptr<llvm::Module> BuiltinSizeModule,
+    const BiFClosureIndexData& BuiltinClosureIndex)
 {
     IGCPassManager mpm(pContext, "Unify");
 
@@ -279,7 +280,7 @@ static void CommonOCLBasedPasses(
 	}
 
     mpm.add(new PreBIImportAnalysis());
-    mpm.add(createBuiltInImportPass(std::move(BuiltinGenericModule), std::move(BuiltinSizeModule)));
+    mpm.add(createBuiltInImportPass(std::move(BuiltinGenericModule), std::move(BuiltinSizeModule), BuiltinClosureIndex));
     mpm.add(new UndefinedReferencesPass());
 
     // Estimate maximal function size in the module and disable subroutine if not profitable.
@@ -452,15 +453,17 @@ static void CommonOCLBasedPasses(
 void UnifyIROCL(
     OpenCLProgramContext* pContext,
     std::unique_ptr<llvm::Module> BuiltinGenericModule,
-    std::unique_ptr<llvm::Module> BuiltinSizeModule)
+    std::unique_ptr<llvm::Module> BuiltinSizeModule,
+    const BiFClosureIndexData& BuiltinClosureIndex)
 {
-    CommonOCLBasedPasses(pContext, std::move(BuiltinGenericModule), std::move(BuiltinSizeModule));
+    CommonOCLBasedPasses(pContext, std::move(BuiltinGenericModule), std::move(BuiltinSizeModule), BuiltinClosureIndex);
 }
 
 void UnifyIRSPIR(
     OpenCLProgramContext* pContext,
     std::unique_ptr<llvm::Module> BuiltinGenericModule,
-    std::unique_ptr<llvm::Module> BuiltinSizeModule)
+    std::unique_ptr<llvm::Module> BuiltinSizeModule,
+    const BiFClosureIndexData& BuiltinClosureIndex)
 {
     int pointerSize = getPointerSize(*pContext->getModule());
 
@@ -478,6 +481,6 @@ void UnifyIRSPIR(
 		BuiltinSizeModule->setTargetTriple("vISA_64");
     }
 
-    CommonOCLBasedPasses(pContext, std::move(BuiltinGenericModule), std::move(BuiltinSizeModule));
+    CommonOCLBasedPasses(pContext, std::move(BuiltinGenericModule), std::move(BuiltinSizeModule), BuiltinClosureIndex);
 }
 }
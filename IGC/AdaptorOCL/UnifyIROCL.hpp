@@ -28,13 +28,17 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 namespace IGC
 {
+    struct BiFClosureIndexData;
+
     void UnifyIROCL(
         OpenCLProgramContext* pContext,
         std::unique_ptr<llvm::Module> BuiltinGenericModule,
-        std::unique_ptr<llvm::Module> BuiltinSizeModule);
+        std::unique_ptr<llvm::Module> BuiltinSizeModule,
+        const BiFClosureIndexData& BuiltinClosureIndex);
 
     void UnifyIRSPIR(
         OpenCLProgramContext* pContext,
         std::unique_ptr<llvm::Module> BuiltinGenericModule,
-        std::unique_ptr<llvm::Module> BuiltinSizeModule);
+        std::unique_ptr<llvm::Module> BuiltinSizeModule,
+        const BiFClosureIndexData& BuiltinClosureIndex);
 }
\ No newline at end of file
@@ -31,6 +31,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "AdaptorCommon/customApi.hpp"
 #include "AdaptorOCL/OCL/LoadBuffer.h"
+#include "AdaptorOCL/OCL/ProgramCache.h"
 #include "AdaptorOCL/OCL/BuiltinResource.h"
 #include "AdaptorOCL/OCL/TB/igc_tb.h"
 
@@ -40,11 +41,14 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "Compiler/MetaDataApi/IGCMetaDataHelper.h"
 #include "Compiler/MetaDataApi/IGCMetaDataDefs.h"
+#include "Compiler/Optimizer/BuiltInFuncImport.h"
 
 #include "common/debug/Dump.hpp"
 #include "common/debug/Debug.hpp"
 #include "common/igc_regkeys.hpp"
 #include "common/secure_mem.h"
+#include "Compiler/CISACodeGen/helper.h"
+#include "CompileTrace.h"
 
 #include "CLElfLib/ElfReader.h"
 #include "usc.h"
@@ -63,6 +67,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include <sstream>
 #include <iomanip>
+#include <map>
+#include <mutex>
 
 //In case of use GT_SYSTEM_INFO in GlobalData.h from inc/umKmInc/sharedata.h
 //We have to do this temporary defines
@@ -127,6 +133,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <llvm/Support/Format.h>
 #include <llvm/Support/MemoryBuffer.h>
 #include <llvm/Support/SourceMgr.h>
+#include <llvm/Transforms/Utils/Cloning.h>
 #include "common/LLVMWarningsPop.hpp"
 
 using namespace IGC::IGCMD;
@@ -598,6 +605,53 @@ void DumpShaderFile(const char *pOutputFolder, const char * pBuffer, UINT buffer
 	}
 }
 
+// Collects the compile trace of one build and writes it next to the shader
+// dumps, as OCL_asm<hash>_trace.json, when the build returns. Tracing is on
+// only while a session is open.
+class CompileTraceSession
+{
+public:
+    explicit CompileTraceSession(QWORD hash) : m_hash(hash), m_start(0), m_enabled(false)
+    {
+        if (IGC_IS_FLAG_ENABLED(DumpCompileTimeTrace))
+        {
+            EnableCompileTrace(true);
+            m_enabled = true;
+            m_start = BeginCompileTraceSession();
+        }
+    }
+
+    ~CompileTraceSession()
+    {
+        if (m_start != 0)
+        {
+            WriteTrace();
+        }
+        if (m_enabled)
+        {
+            EnableCompileTrace(false);
+        }
+    }
+
+private:
+    void WriteTrace()
+    {
+        std::stringstream ss;
+        ss << IGC::Debug::GetShaderOutputFolder()
+            << "OCL_asm"
+            << std::hex
+            << std::setfill('0')
+            << std::setw(sizeof(m_hash) * CHAR_BIT / 4)
+            << m_hash
+            << "_trace.json";
+        EndCompileTraceSession(m_start, ss.str().c_str());
+    }
+
+    QWORD m_hash;
+    uint64_t m_start;
+    bool m_enabled;
+};
+
 #if defined(IGC_SPIRV_ENABLED)
 // Disasseble SPIRV binary file using SPIRV-Tools library
 spv_result_t DisassembleSPIRV(
@@ -632,6 +686,254 @@ spv_result_t DisassembleSPIRV(
 }
 #endif
 
+// The BiF resources are part of the library image and never change, so each of them is
+// looked up (and copied out on Linux) once per process and then shared by every build and
+// every retry of a build. The lazy builtin modules only reference the buffer.
+static llvm::MemoryBuffer* GetBuiltinResource(int ResNumber)
+{
+    static std::mutex resourceMutex;
+    static std::map<int, std::unique_ptr<llvm::MemoryBuffer>> resources;
+
+    std::lock_guard<std::mutex> lock(resourceMutex);
+    std::unique_ptr<llvm::MemoryBuffer>& pBuffer = resources[ResNumber];
+    if (pBuffer == nullptr)
+    {
+        char Resource[5] = { '-' };
+        _snprintf(Resource, sizeof(Resource), "#%d", ResNumber);
+        pBuffer.reset(llvm::LoadBufferFromResource(Resource, "BC"));
+    }
+    return pBuffer.get();
+}
+
+// Links the builtins into the kernel module of the context and runs the unification passes.
+static bool UnifyModule(OpenCLProgramContext& oclContext, unsigned PtrSzInBits, STB_TranslateOutputArgs* pOutputArgs)
+{
+    std::unique_ptr<llvm::Module> BuiltinGenericModule = nullptr;
+    std::unique_ptr<llvm::Module> BuiltinSizeModule = nullptr;
+    IGC::BiFClosureIndexData BuiltinClosureIndex;
+    {
+        // IGC has two BIF Modules: 
+        //            1. kernel Module (pKernelModule)
+        //            2. BIF Modules:
+        //                 a) generic Module (BuiltinGenericModule)
+        //                 b) size Module (BuiltinSizeModule)
+        //
+        // OCL builtin types, such as clk_event_t/queue_t, etc., are struct (opaque) types. For
+        // those types, its original names are themselves; the derived names are ones with
+        // '.<digit>' appended to the original names. For example,  clk_event_t is the original
+        // name, its derived names are clk_event_t.0, clk_event_t.1, etc.
+        //
+        // When llvm reads in multiple modules, say, M0, M1, under the same llvmcontext, if both
+        // M0 and M1 has the same struct type,  M0 will have the original name and M1 the derived
+        // name for that type.  For example, clk_event_t,  M0 will have clk_event_t, while M1 will
+        // have clk_event_t.2 (number is arbitary). After linking, those two named types should be
+        // mapped to the same type, otherwise, we could have type-mismatch (for example, OCL GAS
+        // builtin_functions tests will assert during inlining due to type-mismatch).  Furthermore,
+        // when linking M1 into M0 (M0 : dstModule, M1 : srcModule), the final type is the type
+        // used in M0.
+
+        // Load the builtin module -  Generic BC
+        // Load the builtin module -  Generic BC
+        {
+            llvm::MemoryBuffer* pGenericBuffer = GetBuiltinResource(OCL_BC);
+
+            if (pGenericBuffer == NULL) 
+            {
+                SetErrorMessage("Error loading the Generic builtin resource", *pOutputArgs);
+                return false;
+            }
+
+            llvm::Expected<std::unique_ptr<llvm::Module>> ModuleOrErr =
+                getLazyBitcodeModule(pGenericBuffer->getMemBufferRef(), toLLVMContext(oclContext));
+
+            if (llvm::Error EC = ModuleOrErr.takeError()) 
+            {
+                std::string error_str = "Error lazily loading bitcode for generic builtins,"
+                                        "is bitcode the right version and correctly formed?";
+                SetErrorMessage(error_str, *pOutputArgs);
+                return false;
+            }
+            else
+            {
+                BuiltinGenericModule = std::move(*ModuleOrErr);
+                BuiltinClosureIndex.GenericBitcode = pGenericBuffer->getBuffer();
+            }
+
+            if (BuiltinGenericModule == NULL)
+            {
+                SetErrorMessage("Error loading the Generic builtin module from buffer", *pOutputArgs);
+                return false;
+            }
+        }
+
+        // Load the builtin module -  pointer depended
+        {
+            int ResNumber = 0;
+            switch (PtrSzInBits)
+            {
+            case 32:
+                ResNumber = OCL_BC_32;
+                break;
+            case 64:
+                ResNumber = OCL_BC_64;
+                break;
+            default:
+                assert(0 && "Unknown bitness of compiled module");
+            }
+
+            llvm::MemoryBuffer* pSizeTBuffer = GetBuiltinResource(ResNumber);
+            assert(pSizeTBuffer && "Error loading builtin resource");
+
+            llvm::Expected<std::unique_ptr<llvm::Module>> ModuleOrErr =
+                getLazyBitcodeModule(pSizeTBuffer->getMemBufferRef(), toLLVMContext(oclContext));
+            if (llvm::Error EC = ModuleOrErr.takeError())
+                assert(0 && "Error lazily loading bitcode for size_t builtins");
+            else
+            {
+                BuiltinSizeModule = std::move(*ModuleOrErr);
+                BuiltinClosureIndex.SizeBitcode = pSizeTBuffer->getBuffer();
+            }
+
+            assert(BuiltinSizeModule
+                && "Error loading builtin module from buffer");
+        }
+
+        // Load the builtin closure index matching the size_t module. Builds of the BiF
+        // library without it import builtins by walking their call graph.
+        {
+            llvm::MemoryBuffer* pIndexBuffer =
+                GetBuiltinResource(PtrSzInBits == 32 ? OCL_BC_INDEX_32 : OCL_BC_INDEX_64);
+            if (pIndexBuffer)
+            {
+                BuiltinClosureIndex.Index = pIndexBuffer->getBuffer();
+            }
+        }
+
+        BuiltinGenericModule->setDataLayout(BuiltinSizeModule->getDataLayout());
+        BuiltinGenericModule->setTargetTriple(BuiltinSizeModule->getTargetTriple());
+    }
+
+    if (llvm::StringRef(oclContext.getModule()->getTargetTriple()).startswith("spir"))
+    {
+        IGC::UnifyIRSPIR(&oclContext, std::move(BuiltinGenericModule), std::move(BuiltinSizeModule), BuiltinClosureIndex);
+    }
+    else // not SPIR
+    {
+        IGC::UnifyIROCL(&oclContext, std::move(BuiltinGenericModule), std::move(BuiltinSizeModule), BuiltinClosureIndex);
+    }
+
+    if (!(oclContext.oclErrorMessage.empty()))
+    {
+         //The error buffer returned will be deleted when the module is unloaded so
+         //a copy is necessary
+        if (const char *pErrorMsg = oclContext.oclErrorMessage.c_str())
+        {
+            SetErrorMessage(oclContext.oclErrorMessage, *pOutputArgs);
+        }
+        return false;
+    }
+
+    return true;
+}
+
+// Replaces the module of the context with a copy of the unified (not yet optimized) module
+// saved on the first try, keeping only what the kernels of the retry set need. Kernels that
+// did not spill keep the binaries they got on the first try and are not optimized again.
+// The per-attempt state is reset the same way as for a full retry; only the LLVM context,
+// which owns the saved module, is kept.
+static void RestoreUnifiedModule(OpenCLProgramContext& oclContext, const llvm::Module& unifiedModule)
+{
+    oclContext.clearModule();
+    oclContext.setModule(llvm::CloneModule(&unifiedModule).release());
+    deserialize(*oclContext.getModuleMetaData(), oclContext.getModule());
+
+    IGCMD::MetaDataUtils* pMdUtils = oclContext.getMetaDataUtils();
+    auto& FuncMD = oclContext.getModuleMetaData()->FuncMD;
+    auto eraseFunction = [&](llvm::Function* pFunc)
+    {
+        auto Iter = pMdUtils->findFunctionsInfoItem(pFunc);
+        if (Iter != pMdUtils->end_FunctionsInfo())
+        {
+            pMdUtils->eraseFunctionsInfoItem(Iter);
+        }
+        FuncMD.erase(pFunc);
+        pFunc->eraseFromParent();
+    };
+
+    const std::set<std::string>& kernelSet = oclContext.m_retryManager.kernelSet;
+    std::vector<llvm::Function*> doneKernels;
+    for (auto& F : *oclContext.getModule())
+    {
+        if (isEntryFunc(pMdUtils, &F) && F.use_empty() && kernelSet.count(F.getName().str()) == 0)
+        {
+            doneKernels.push_back(&F);
+        }
+    }
+    for (auto pFunc : doneKernels)
+    {
+        eraseFunction(pFunc);
+    }
+
+    // Drop the functions that were only called by the removed kernels.
+    bool changed = !doneKernels.empty();
+    while (changed)
+    {
+        changed = false;
+        for (auto I = oclContext.getModule()->begin(), E = oclContext.getModule()->end(); I != E; )
+        {
+            llvm::Function* pFunc = &(*I++);
+            if (!pFunc->isDeclaration() && pFunc->use_empty() && !isEntryFunc(pMdUtils, pFunc))
+            {
+                eraseFunction(pFunc);
+                changed = true;
+            }
+        }
+    }
+
+    pMdUtils->save(toLLVMContext(oclContext));
+}
+
+#if defined(IGC_DEBUG_VARIABLES)
+// Builds the program again with the parallel compiles off and compares the
+// program binary and debug data with the output of the parallel build. The
+// serial build runs before the parallel output is stored in the program cache,
+// so it is never served from the cache.
+static bool MatchesSerialBuild(
+    const STB_TranslateInputArgs* pInputArgs,
+    const STB_TranslateOutputArgs& parallelOutput,
+    TB_DATA_FORMAT inputDataFormatTemp,
+    const IGC::CPlatform& IGCPlatform,
+    float profilingTimerResolution)
+{
+    if (IGC_IS_FLAG_DISABLED(EnableOCLParallelKernelCompile) &&
+        IGC_IS_FLAG_DISABLED(EnableOCLParallelSIMDCompile))
+    {
+        return true;
+    }
+
+    const unsigned parallelKernels = g_RegKeyList.EnableOCLParallelKernelCompile.m_Value;
+    const unsigned parallelSIMD = g_RegKeyList.EnableOCLParallelSIMDCompile.m_Value;
+    IGC_SET_FLAG_VALUE(EnableOCLParallelKernelCompile, false);
+    IGC_SET_FLAG_VALUE(EnableOCLParallelSIMDCompile, false);
+    STB_TranslateOutputArgs serialOutput;
+    bool success = TranslateBuild(pInputArgs, &serialOutput, inputDataFormatTemp, IGCPlatform, profilingTimerResolution);
+    IGC_SET_FLAG_VALUE(EnableOCLParallelKernelCompile, parallelKernels);
+    IGC_SET_FLAG_VALUE(EnableOCLParallelSIMDCompile, parallelSIMD);
+
+    bool match = success &&
+        serialOutput.OutputSize == parallelOutput.OutputSize &&
+        serialOutput.DebugDataSize == parallelOutput.DebugDataSize &&
+        memcmp(serialOutput.pOutput, parallelOutput.pOutput, serialOutput.OutputSize) == 0 &&
+        (serialOutput.DebugDataSize == 0 ||
+         memcmp(serialOutput.pDebugData, parallelOutput.pDebugData, serialOutput.DebugDataSize) == 0);
+
+    delete[] serialOutput.pOutput;
+    delete[] serialOutput.pDebugData;
+    delete[] serialOutput.pErrorString;
+    return match;
+}
+#endif
+
 bool TranslateBuild(
     const STB_TranslateInputArgs* pInputArgs,
     STB_TranslateOutputArgs* pOutputArgs,
@@ -646,12 +948,19 @@ bool TranslateBuild(
     
     MEM_USAGERESET;
 
+    ProgramCache programCache(pInputArgs, IGCPlatform, profilingTimerResolution);
+    if (!GTPIN_IGC_OCL_IsEnabled() && programCache.Load(pOutputArgs))
+    {
+        return true;
+    }
+
     // Parse the module we want to compile
     llvm::Module* pKernelModule = nullptr;
     LLVMContextWrapper* llvmContext = new LLVMContextWrapper;
     RegisterComputeErrHandlers(*llvmContext);
 
 	ShaderHash inputShHash = ShaderHashOCL((const UINT*)pInputArgs->pInput, pInputArgs->InputSize / 4);
+	CompileTraceSession traceSession(inputShHash.getAsmHash());
 
 	if (IGC_IS_FLAG_ENABLED(ShaderDumpEnable))
 	{
@@ -739,121 +1048,27 @@ bool TranslateBuild(
     /// set retry manager
     bool retry = false;
     oclContext.m_retryManager.Enable();
+    /// unified module of the first try, the starting point of the retries
+    std::unique_ptr<llvm::Module> unifiedModule;
     do
     {
-        std::unique_ptr<llvm::Module> BuiltinGenericModule = nullptr;
-        std::unique_ptr<llvm::Module> BuiltinSizeModule = nullptr;
-        std::unique_ptr<llvm::MemoryBuffer> pGenericBuffer = nullptr;
-        std::unique_ptr<llvm::MemoryBuffer> pSizeTBuffer = nullptr;
-		{
-			// IGC has two BIF Modules: 
-			//            1. kernel Module (pKernelModule)
-			//            2. BIF Modules:
-			//                 a) generic Module (BuiltinGenericModule)
-			//                 b) size Module (BuiltinSizeModule)
-			//
-			// OCL builtin types, such as clk_event_t/queue_t, etc., are struct (opaque) types. For
-			// those types, its original names are themselves; the derived names are ones with
-			// '.<digit>' appended to the original names. For example,  clk_event_t is the original
-			// name, its derived names are clk_event_t.0, clk_event_t.1, etc.
-			//
-			// When llvm reads in multiple modules, say, M0, M1, under the same llvmcontext, if both
-			// M0 and M1 has the same struct type,  M0 will have the original name and M1 the derived
-			// name for that type.  For example, clk_event_t,  M0 will have clk_event_t, while M1 will
-			// have clk_event_t.2 (number is arbitary). After linking, those two named types should be
-			// mapped to the same type, otherwise, we could have type-mismatch (for example, OCL GAS
-			// builtin_functions tests will assert during inlining due to type-mismatch).  Furthermore,
-			// when linking M1 into M0 (M0 : dstModule, M1 : srcModule), the final type is the type
-			// used in M0.
-
-			// Load the builtin module -  Generic BC
-			// Load the builtin module -  Generic BC
-			{
-				char Resource[5] = { '-' };
-				_snprintf(Resource, sizeof(Resource), "#%d", OCL_BC);
-
-				pGenericBuffer.reset(llvm::LoadBufferFromResource(Resource, "BC"));
-
-                if (pGenericBuffer == NULL) 
-                {
-                    SetErrorMessage("Error loading the Generic builtin resource", *pOutputArgs);
-                    return false;
-                }
-
-                llvm::Expected<std::unique_ptr<llvm::Module>> ModuleOrErr =
-                    getLazyBitcodeModule(pGenericBuffer->getMemBufferRef(), toLLVMContext(oclContext));
-                
-                if (llvm::Error EC = ModuleOrErr.takeError()) 
-                {
-                    std::string error_str = "Error lazily loading bitcode for generic builtins,"
-                                            "is bitcode the right version and correctly formed?";
-                    SetErrorMessage(error_str, *pOutputArgs);
-                    return false;
-                }
-                else
-                {
-                    BuiltinGenericModule = std::move(*ModuleOrErr);
-                }
-
-                if (BuiltinGenericModule == NULL)
-                {
-                    SetErrorMessage("Error loading the Generic builtin module from buffer", *pOutputArgs);
-                    return false;
-                }
-			}
-
-			// Load the builtin module -  pointer depended
-			{
-				char ResNumber[5] = { '-' };
-				switch (PtrSzInBits)
-				{
-				case 32:
-					_snprintf(ResNumber, sizeof(ResNumber), "#%d", OCL_BC_32);
-					break;
-				case 64:
-					_snprintf(ResNumber, sizeof(ResNumber), "#%d", OCL_BC_64);
-					break;
-				default:
-					assert(0 && "Unknown bitness of compiled module");
-				}
-
-				// the MemoryBuffer becomes owned by the module and does not need to be managed
-				pSizeTBuffer.reset(llvm::LoadBufferFromResource(ResNumber, "BC"));
-				assert(pSizeTBuffer && "Error loading builtin resource");
-
-				llvm::Expected<std::unique_ptr<llvm::Module>> ModuleOrErr =
-					getLazyBitcodeModule(pSizeTBuffer->getMemBufferRef(), toLLVMContext(oclContext));
-				if (llvm::Error EC = ModuleOrErr.takeError())
-					assert(0 && "Error lazily loading bitcode for size_t builtins");
-				else
-					BuiltinSizeModule = std::move(*ModuleOrErr);
-
-				assert(BuiltinSizeModule
-					&& "Error loading builtin module from buffer");
-			}
-
-			BuiltinGenericModule->setDataLayout(BuiltinSizeModule->getDataLayout());
-			BuiltinGenericModule->setTargetTriple(BuiltinSizeModule->getTargetTriple());
-		}
-
-        if (llvm::StringRef(oclContext.getModule()->getTargetTriple()).startswith("spir"))
+        if (unifiedModule)
         {
-            IGC::UnifyIRSPIR(&oclContext, std::move(BuiltinGenericModule), std::move(BuiltinSizeModule));
+            RestoreUnifiedModule(oclContext, *unifiedModule);
         }
-        else // not SPIR
+        else
         {
-            IGC::UnifyIROCL(&oclContext, std::move(BuiltinGenericModule), std::move(BuiltinSizeModule));
-        }
+            if (!UnifyModule(oclContext, PtrSzInBits, pOutputArgs))
+            {
+                return false;
+            }
 
-        if (!(oclContext.oclErrorMessage.empty()))
-        {
-             //The error buffer returned will be deleted when the module is unloaded so
-             //a copy is necessary
-            if (const char *pErrorMsg = oclContext.oclErrorMessage.c_str())
+            if (IGC_IS_FLAG_ENABLED(EnableOCLIncrementalRetry) && !oclContext.m_retryManager.IsLastTry())
             {
-                SetErrorMessage(oclContext.oclErrorMessage, *pOutputArgs);
+                oclContext.getMetaDataUtils()->save(toLLVMContext(oclContext));
+                serialize(*oclContext.getModuleMetaData(), oclContext.getModule());
+                unifiedModule = llvm::CloneModule(oclContext.getModule());
             }
-            return false;
         }
 
         // Compiler Options information available after unification.
@@ -873,7 +1088,7 @@ bool TranslateBuild(
         retry = (oclContext.m_retryManager.AdvanceState() &&
                 !oclContext.m_retryManager.kernelSet.empty());
 
-        if (retry)
+        if (retry && !unifiedModule)
         {
             oclContext.clear();
 
@@ -891,6 +1106,7 @@ bool TranslateBuild(
     } while (retry);
 
     // Create the binary streams for each compiled kernel
+    COMPILER_TIME_START(&oclContext, TIME_OCL_ProgramBinary);
     oclContext.m_programOutput.CreateKernelBinaries();
 
     unsigned int pointerSizeInBytes = (PtrSzInBits == 64) ? 8 : 4; 
@@ -899,10 +1115,9 @@ bool TranslateBuild(
     Util::BinaryStream programBinary;
     oclContext.m_programOutput.GetProgramBinary(programBinary, pointerSizeInBytes);
 
+    // The stream buffer is handed over as is, it is freed with delete[] like a copy would be.
     int binarySize = static_cast<int>(programBinary.Size());
-    char* binaryOutput = new char[binarySize];
-    memcpy_s(binaryOutput, binarySize, (char*)programBinary.GetLinearPointer(), binarySize);
-
+    char* binaryOutput = programBinary.Release();
 
     pOutputArgs->OutputSize = binarySize;
     pOutputArgs->pOutput = binaryOutput;
@@ -914,12 +1129,29 @@ bool TranslateBuild(
     int debugDataSize = int_cast<int>(programDebugData.Size());
     if (debugDataSize > 0)
     {
-        char* debugDataOutput = new char[debugDataSize];
-        memcpy_s(debugDataOutput, debugDataSize, (char*)programDebugData.GetLinearPointer(), debugDataSize);
+        char* debugDataOutput = programDebugData.Release();
 
         pOutputArgs->DebugDataSize = debugDataSize;
         pOutputArgs->pDebugData = debugDataOutput;
     }
+    COMPILER_TIME_END(&oclContext, TIME_OCL_ProgramBinary);
+
+#if defined(IGC_DEBUG_VARIABLES)
+    if (IGC_IS_FLAG_ENABLED(CheckOCLParallelKernelCompile) && !GTPIN_IGC_OCL_IsEnabled() &&
+        !MatchesSerialBuild(pInputArgs, *pOutputArgs, inputDataFormatTemp, IGCPlatform, profilingTimerResolution))
+    {
+        delete[] pOutputArgs->pOutput;
+        delete[] pOutputArgs->pDebugData;
+        pOutputArgs->pOutput = nullptr;
+        pOutputArgs->OutputSize = 0;
+        pOutputArgs->pDebugData = nullptr;
+        pOutputArgs->DebugDataSize = 0;
+        SetErrorMessage("Parallel kernel compile does not match the serial build!", *pOutputArgs);
+        return false;
+    }
+#endif
+
+    programCache.Store(pOutputArgs);
 
     const char* driverName =
         GTPIN_DRIVERVERSION_OPEN;
@@ -193,8 +193,8 @@ CIF_DECLARE_INTERFACE_PIMPL(IgcOclTranslationCtx) : CIF::PimplBase
         bool dataCopiedSuccessfuly = true;
         if(success){
             dataCopiedSuccessfuly &= outputInterface->GetImpl()->AddWarning(output.pErrorString, output.ErrorStringSize);
-            dataCopiedSuccessfuly &= outputInterface->GetImpl()->CloneDebugData(output.pDebugData, output.DebugDataSize);
-            dataCopiedSuccessfuly &= outputInterface->GetImpl()->SetSuccessfulAndCloneOutput(output.pOutput, output.OutputSize);
+            dataCopiedSuccessfuly &= outputInterface->GetImpl()->TakeDebugData(debugData.release(), output.DebugDataSize);
+            dataCopiedSuccessfuly &= outputInterface->GetImpl()->SetSuccessfulAndTakeOutput(outputData.release(), output.OutputSize);
         }else{
             dataCopiedSuccessfuly &= outputInterface->GetImpl()->SetError(TranslationErrorType::FailedCompilation, output.pErrorString);
         }
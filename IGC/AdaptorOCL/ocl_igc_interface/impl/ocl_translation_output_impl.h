@@ -146,7 +146,30 @@ CIF_DECLARE_INTERFACE_PIMPL(OclTranslationOutput) : CIF::PimplBase
         return DebugData->PushBackRawBytes(data, size);
     }
 
+    /// Takes ownership of data, which must have been allocated with new[], instead of copying it
+    bool SetSuccessfulAndTakeOutput(char * data, size_t size)
+    {
+        this->Error = TranslationErrorType::Success;
+        Output->SetUnderlyingStorage(data, size, &DeleteArray);
+        return true;
+    }
+
+    /// Takes ownership of data, which must have been allocated with new[], instead of copying it
+    bool TakeDebugData(char * data, size_t size)
+    {
+        if(data == nullptr){
+            return true;
+        }
+        DebugData->SetUnderlyingStorage(data, size, &DeleteArray);
+        return true;
+    }
+
 protected:
+    static void CIF_CALLING_CONV DeleteArray(void * memory)
+    {
+        delete [] reinterpret_cast<char*>(memory);
+    }
+
     CIF::Multiversion<CIF::Builtins::Buffer> BuildLog;
     CIF::Multiversion<CIF::Builtins::Buffer> Output;
     CIF::Multiversion<CIF::Builtins::Buffer> DebugData;
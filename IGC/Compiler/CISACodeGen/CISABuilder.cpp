@@ -30,6 +30,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "common/allocator.h"
 #include "common/Types.hpp"
 #include "common/Stats.hpp"
+#include "CompileTrace.h"
 #include "common/MemStats.h"
 #include "common/debug/Dump.hpp"
 #include "common/igc_regkeys.hpp"
@@ -39,6 +40,13 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include <iStdLib/utility.h>
 
+// Functions exposed by VISA lib API to run a compile on another thread
+extern "C" unsigned int getTimerStateSize();
+extern "C" void handOffTimers(void* state);
+extern "C" void takeOverTimers(const void* state);
+extern "C" void handBackTimers(void* state);
+extern "C" void restoreTimers(const void* state);
+
 #if !defined(_WIN32)
 #   define _strdup strdup
 #   define _snprintf snprintf
@@ -3509,6 +3517,18 @@ void CEncoder::InitEncoder( bool canAbortOnSpill )
         {
             vbuilder->SetOption(vISA_preRA_ScheduleRPThreshold, Val);
         }
+
+        if (uint32_t Val = IGC_GET_FLAG_VALUE(VISAPreSchedGRFBudget))
+        {
+            vbuilder->SetOption(vISA_preRA_ScheduleGRFBudget, Val);
+        }
+        else if (IGC_IS_FLAG_ENABLED(EnablePressureFirstPreSched) &&
+            m_program->m_dispatchSize != SIMDMode::SIMD8)
+        {
+            // Trade latency hiding for fitting the wider SIMD width in the
+            // GRF file, a spill costs more than what the latency schedule gains.
+            vbuilder->SetOption(vISA_preRA_ScheduleGRFBudget, context->getNumGRFPerThread());
+        }
     }
     else
     {
@@ -3527,6 +3547,22 @@ void CEncoder::InitEncoder( bool canAbortOnSpill )
         vbuilder->SetOption(vISA_postRA_ScheduleBlock, BBName);
     }
 
+    if (IGC_IS_FLAG_ENABLED(VISALatencyModelFile))
+    {
+        const char* fileName = IGC_GET_REGKEYSTRING(VISALatencyModelFile);
+        vbuilder->SetOption(vISA_LatencyModelFile, fileName);
+    }
+
+    if (uint32_t Val = IGC_GET_FLAG_VALUE(VISAPostSchedThreads))
+    {
+        vbuilder->SetOption(vISA_ParallelSchedulingThreads, Val);
+    }
+
+    if (uint32_t Val = IGC_GET_FLAG_VALUE(VISAParallelCompileThreads))
+    {
+        vbuilder->SetOption(vISA_ParallelCompileThreads, Val);
+    }
+
     if (IGC_IS_FLAG_ENABLED(FastSpill))
     {
         vbuilder->SetOption(vISA_FastSpill, true);
@@ -3585,6 +3621,11 @@ void CEncoder::InitEncoder( bool canAbortOnSpill )
         vbuilder->SetOption(vISA_NoRemat, true);
     }
 
+    if (IGC_IS_FLAG_ENABLED(enableMultiSpillHeuristicRA))
+    {
+        vbuilder->SetOption(vISA_MultiSpillHeuristicRA, true);
+    }
+
     if (ForceNonCoherentStatelessBti || IGC_IS_FLAG_ENABLED(ForceNonCoherentStatelessBTI))
     {
         vbuilder->SetOption(vISA_noncoherentStateless, true);
@@ -4141,22 +4182,16 @@ void CEncoder::Compile()
     //Compile to generate the V-ISA binary
     //TARGET_PLATFORM VISAPlatform = GetVISAPlatform(m_Platform);
     int vIsaCompile = 0;
-    if( m_enableVISAdump )
+    if (m_vIsaCompileResult.valid())
     {
-        std::string isaName = IGC::Debug::GetDumpName(m_program, "isa");
-        // vISA does not support string of length >= 255. Truncate if this exceeds
-        // the limit. Note that vISA may append an extension, so relax it to a
-        // random number 240 here.
-        const int MAX_VISA_STRING_LENGTH = 240;
-        if (isaName.length() >= MAX_VISA_STRING_LENGTH)
-        {
-            isaName.resize(MAX_VISA_STRING_LENGTH);
-        }
-        vIsaCompile = vbuilder->Compile(const_cast<char*>(isaName.c_str()));
+        // the compile was started by CompileAsync(), collect its result
+        vIsaCompile = m_vIsaCompileResult.get();
+        restoreTimers(m_vIsaCompileTimers.data());
     }
     else
     {
-        vIsaCompile = vbuilder->Compile("");
+        CompileTraceScope traceScope(GetCompileTraceName());
+        vIsaCompile = vbuilder->Compile(GetVISADumpName().c_str());
     }
     FINALIZER_INFO *jitInfo;
     vMainKernel->GetJitInfo(jitInfo);
@@ -4231,6 +4266,7 @@ void CEncoder::Compile()
         m_program->m_sendStallCycle = sendStallCycle;
         m_program->m_staticCycle = staticCycle;
     }
+    m_program->m_maxGRFPressure = jitInfo->maxGRFPressure;
 
     if (jitInfo->isSpill && AvoidRetryOnSmallSpill())
     {
@@ -4353,8 +4389,69 @@ void CEncoder::Compile()
     COMPILER_TIME_END(m_program->GetContext(), TIME_CG_vISAEmitPass);
 }
 
+std::string CEncoder::GetVISADumpName()
+{
+    std::string isaName;
+    if( m_enableVISAdump )
+    {
+        isaName = IGC::Debug::GetDumpName(m_program, "isa");
+        // vISA does not support string of length >= 255. Truncate if this exceeds
+        // the limit. Note that vISA may append an extension, so relax it to a
+        // random number 240 here.
+        const int MAX_VISA_STRING_LENGTH = 240;
+        if (isaName.length() >= MAX_VISA_STRING_LENGTH)
+        {
+            isaName.resize(MAX_VISA_STRING_LENGTH);
+        }
+    }
+    return isaName;
+}
+
+void CEncoder::CompileAsync()
+{
+    assert(!m_vIsaCompileResult.valid() && "vISA compile already started");
+    // The dump name is computed here as the dump helpers are not thread safe.
+    std::string isaName = GetVISADumpName();
+    std::string traceName = GetCompileTraceName();
+    VISABuilder* builder = vbuilder;
+    // vISA timers, platform and current builder are per thread; the worker
+    // enters the builder, carries on from this thread's timers and leaves its
+    // totals in m_vIsaCompileTimers
+    m_vIsaCompileTimers.assign((getTimerStateSize() + sizeof(int64_t) - 1) / sizeof(int64_t), 0);
+    handOffTimers(m_vIsaCompileTimers.data());
+    int64_t* timers = m_vIsaCompileTimers.data();
+    m_vIsaCompileResult = std::async(std::launch::async, [builder, isaName, traceName, timers]()
+    {
+        V(EnterVISABuilderThread(builder));
+        takeOverTimers(timers);
+        int status = 0;
+        {
+            CompileTraceScope traceScope(traceName);
+            status = builder->Compile(isaName.c_str());
+        }
+        handBackTimers(timers);
+        return status;
+    });
+}
+
+std::string CEncoder::GetCompileTraceName() const
+{
+    if (!IsCompileTraceEnabled())
+    {
+        return std::string();
+    }
+    return "vISA compile " + m_program->entry->getName().str() +
+        " SIMD" + std::to_string(numLanes(m_program->m_dispatchSize));
+}
+
 void CEncoder::DestroyVISABuilder()
 {
+    // never free the builder under a running compile
+    if (m_vIsaCompileResult.valid())
+    {
+        m_vIsaCompileResult.wait();
+        m_vIsaCompileResult = std::future<int>();
+    }
     V(::DestroyVISABuilder(vbuilder));
     vbuilder = nullptr;
 }
@@ -32,6 +32,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "visa_wa.h"
 
+#include <future>
+
 
 namespace IGC
 {
@@ -143,6 +145,9 @@ public:
     void DeclareInput(CVariable* var, uint offset, uint instance);
     void MarkAsOutput(CVariable* var);
     void Compile();
+    /// \brief Starts the vISA compile of this kernel on a worker thread.
+    /// The following call to Compile() waits for it and reads back the results.
+    void CompileAsync();
     CEncoder();
     ~CEncoder();
     void SetProgram(CShader* program);
@@ -396,6 +401,8 @@ public:
 
 private:
     // helper functions
+    std::string GetVISADumpName();
+    std::string GetCompileTraceName() const;
     VISA_VectorOpnd* GetSourceOperand(CVariable* var, const SModifier& mod);
     VISA_VectorOpnd* GetSourceOperandNoModifier(CVariable* var);
     VISA_VectorOpnd* GetDestinationOperand(CVariable* var, const SModifier& mod);
@@ -503,6 +510,11 @@ protected:
     VISAKernel*   vKernel;
     VISAKernel*   vMainKernel;
     VISABuilder* vbuilder;
+
+    /// Result of a vISA compile started by CompileAsync(), if any
+    std::future<int> m_vIsaCompileResult;
+    /// vISA timers of that compile, written by the compiling thread
+    std::vector<int64_t> m_vIsaCompileTimers;
     
     bool m_enableVISAdump;
     std::vector<VISA_LabelOpnd*> labelMap;
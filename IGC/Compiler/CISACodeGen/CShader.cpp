@@ -73,6 +73,7 @@ void CShader::InitEncoder(SIMDMode simdSize, bool canAbortOnSpill, ShaderDispatc
 {
     m_sendStallCycle = 0;
     m_staticCycle = 0;
+    m_maxGRFPressure = 0;
     m_maxBlockId = 0;
     m_ScratchSpaceSize = 0;
     m_R0 = nullptr;
@@ -629,6 +630,11 @@ CShader::~CShader()
     Destroy();
 }
 
+bool CShader::HasStackCalls() const
+{
+    return m_FGA && m_FGA->getGroup(entry) && m_FGA->getGroup(entry)->hasStackCall();
+}
+
 bool CShader::IsValueUsed(llvm::Value* value)
 {
     auto it = symbolMapping.find(value);
@@ -42,6 +42,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "common/debug/Dump.hpp"
 #include "common/igc_regkeys.hpp"
 #include "common/Stats.hpp"
+#include "CompileTrace.h"
 #include "Compiler/CISACodeGen/helper.h"
 #include "common/secure_mem.h"
 #include "iStdLib/File.h"
@@ -56,6 +57,9 @@ using namespace std;
 
 char EmitPass::ID = 0;
 
+static void SetStackCallScratchSpace(CShader* shader);
+static void SetMidThreadPreemption(CShader* shader);
+
 EmitPass::EmitPass(CShaderProgram::KernelShaderMap &shaders, SIMDMode mode, bool canAbortOnSpill, ShaderDispatchMode shaderMode, PSSignature* pSignature)
     : FunctionPass(ID),
       m_SimdMode(mode),
@@ -353,6 +357,9 @@ bool EmitPass::runOnFunction(llvm::Function &F)
         return false;
     }
 
+    CompileTraceScope traceScope(IsCompileTraceEnabled() ?
+        "EmitPass " + F.getName().str() + " SIMD" + std::to_string(numLanes(m_SimdMode)) : std::string());
+
     bool isCloned = false;
     if (DebugInfoData::hasDebugInfo(m_currShader))
     {
@@ -622,17 +629,20 @@ bool EmitPass::runOnFunction(llvm::Function &F)
 
     // Compile only when this is the last function for this kernel.
     bool destroyVISABuilder = false;
+    if (finalize && m_currShader->CanCompileSIMDInParallel(F))
+    {
+        // SIMDCompileJoinPass collects the result and releases the builder.
+        // Parallel compiles have no debug info, so the emitter can go now.
+        m_encoder->CompileAsync();
+        IF_DEBUG_INFO(IDebugEmitter::Release(m_pDebugEmitter);)
+        m_currShader->GetParent()->m_pendingCompiles.push_back(m_currShader);
+        return false;
+    }
     if (finalize)
     {
         destroyVISABuilder = true;
         m_encoder->Compile();
-        // if we are doing stack-call, do the following:
-        // - Hard-code a large scratch-space for visa
-        if (m_FGA && m_FGA->getGroup(&F)->hasStackCall())
-        {
-            m_currShader->ProgramOutput()->m_scratchSpaceUsedBySpills =
-                MAX(m_currShader->ProgramOutput()->m_scratchSpaceUsedBySpills, 32 * 1024);
-        }
+        SetStackCallScratchSpace(m_currShader);
     }
 
     if (destroyVISABuilder)
@@ -647,28 +657,113 @@ bool EmitPass::runOnFunction(llvm::Function &F)
         }
     }
 
-    if ((m_currShader->GetShaderType() == ShaderType::COMPUTE_SHADER ||
-        m_currShader->GetShaderType() == ShaderType::OPENCL_SHADER) &&
-        m_currShader->m_Platform->supportDisableMidThreadPreemptionSwitch() &&
+    SetMidThreadPreemption(m_currShader);
+
+    return false;
+}
+
+static void SetStackCallScratchSpace(CShader* shader)
+{
+    // if we are doing stack-call, do the following:
+    // - Hard-code a large scratch-space for visa
+    if (shader->HasStackCalls())
+    {
+        shader->ProgramOutput()->m_scratchSpaceUsedBySpills =
+            MAX(shader->ProgramOutput()->m_scratchSpaceUsedBySpills, 32 * 1024);
+    }
+}
+
+static void SetMidThreadPreemption(CShader* shader)
+{
+    if ((shader->GetShaderType() == ShaderType::COMPUTE_SHADER ||
+        shader->GetShaderType() == ShaderType::OPENCL_SHADER) &&
+        shader->m_Platform->supportDisableMidThreadPreemptionSwitch() &&
         IGC_IS_FLAG_ENABLED(EnableDisableMidThreadPreemptionOpt) &&
-        (m_currShader->GetContext()->m_instrTypes.numLoopInsts == 0) &&
-        (m_currShader->ProgramOutput()->m_InstructionCount < IGC_GET_FLAG_VALUE(MidThreadPreemptionDisableThreshold)))
+        (shader->GetContext()->m_instrTypes.numLoopInsts == 0) &&
+        (shader->ProgramOutput()->m_InstructionCount < IGC_GET_FLAG_VALUE(MidThreadPreemptionDisableThreshold)))
     {
-        if (m_currShader->GetShaderType() == ShaderType::COMPUTE_SHADER)
+        if (shader->GetShaderType() == ShaderType::COMPUTE_SHADER)
         {
-            CComputeShader* csProgram = static_cast<CComputeShader*>(m_currShader);
+            CComputeShader* csProgram = static_cast<CComputeShader*>(shader);
             csProgram->SetDisableMidthreadPreemption();
         }
         else
         {
-            COpenCLKernel* kernel = static_cast<COpenCLKernel*>(m_currShader);
+            COpenCLKernel* kernel = static_cast<COpenCLKernel*>(shader);
             kernel->SetDisableMidthreadPreemption();
         }
     }
+}
+
+char SIMDCompileJoinPass::ID = 0;
+
+SIMDCompileJoinPass::SIMDCompileJoinPass(
+    CShaderProgram::KernelShaderMap &shaders,
+    std::deque<CShaderProgram*> &pendingPrograms,
+    unsigned maxPendingCompiles)
+    : FunctionPass(ID),
+      m_shaders(shaders),
+      m_pendingPrograms(pendingPrograms),
+      m_maxPendingCompiles(maxPendingCompiles)
+{
+}
 
+bool SIMDCompileJoinPass::runOnFunction(llvm::Function &F)
+{
+    llvm::Function *Kernel = &F;
+    GenXFunctionGroupAnalysis *FGA = getAnalysisIfAvailable<GenXFunctionGroupAnalysis>();
+    if (FGA && FGA->getModule())
+    {
+        // the kernel is compiled once the whole group is emitted
+        auto FG = FGA->getGroup(&F);
+        if (!FG || !FGA->isGroupTail(&F))
+        {
+            return false;
+        }
+        Kernel = FG->getHead();
+    }
+
+    auto Iter = m_shaders.find(Kernel);
+    if (Iter == m_shaders.end() || Iter->second->m_pendingCompiles.empty())
+    {
+        return false;
+    }
+    m_pendingPrograms.push_back(Iter->second);
+
+    // Kernels are committed in emission order, the oldest first when there
+    // are too many compiles in flight.
+    unsigned numPending = 0;
+    for (CShaderProgram* program : m_pendingPrograms)
+    {
+        numPending += program->m_pendingCompiles.size();
+    }
+    while (!m_pendingPrograms.empty() && numPending > m_maxPendingCompiles)
+    {
+        CShaderProgram* program = m_pendingPrograms.front();
+        numPending -= program->m_pendingCompiles.size();
+        CommitPendingCompiles(program);
+        m_pendingPrograms.pop_front();
+    }
     return false;
 }
 
+void SIMDCompileJoinPass::CommitPendingCompiles(CShaderProgram* program)
+{
+    for (CShader* shader : program->m_pendingCompiles)
+    {
+        // Commit in the order the variants were emitted so that each decision
+        // sees the same results as in a serial compile.
+        if (shader->KeepParallelSIMDCompile())
+        {
+            shader->GetEncoder().Compile();
+            SetStackCallScratchSpace(shader);
+            SetMidThreadPreemption(shader);
+        }
+        shader->GetEncoder().DestroyVISABuilder();
+    }
+    program->m_pendingCompiles.clear();
+}
+
 // Emit code in slice starting from (reverse) iterator I. Return the iterator to
 // the next pattern to emit.
 SBasicBlock::reverse_iterator
@@ -39,6 +39,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "common/LLVMWarningsPop.hpp"
 #include "Compiler/IGCPassSupport.h"
 
+#include <deque>
+
 namespace llvm
 {
     class GenIntrinsicInst;
@@ -530,4 +532,35 @@ private:
     CVariable *UnpackOrBroadcastIfUniform(CVariable *pVar);
 };
 
+/// Waits for the vISA compiles that EmitPass started in the background for
+/// the SIMD variants of a kernel and commits them in emission order, dropping
+/// the ones the SIMD selection rules would not have compiled.
+/// Up to maxPendingCompiles compiles are left running across kernels, the
+/// caller commits the remaining pendingPrograms once the passes are run.
+class SIMDCompileJoinPass : public llvm::FunctionPass
+{
+public:
+    SIMDCompileJoinPass(
+        CShaderProgram::KernelShaderMap &shaders,
+        std::deque<CShaderProgram*> &pendingPrograms,
+        unsigned maxPendingCompiles);
+
+    virtual void getAnalysisUsage(llvm::AnalysisUsage &AU) const override
+    {
+        AU.setPreservesAll();
+    }
+
+    virtual bool runOnFunction(llvm::Function &F) override;
+    virtual llvm::StringRef getPassName() const override { return "SIMDCompileJoinPass"; }
+
+    static void CommitPendingCompiles(CShaderProgram* program);
+
+    static char ID;
+
+private:
+    CShaderProgram::KernelShaderMap &m_shaders;
+    std::deque<CShaderProgram*> &m_pendingPrograms;
+    unsigned m_maxPendingCompiles;
+};
+
 } // namespace IGC
@@ -66,6 +66,7 @@ CShader(pFunc, pProgram)
     m_HasTID                = false;
     m_HasGlobalSize         = false;
     m_disableMidThreadPreemption = false;
+    m_parallelSIMDSelected  = false;
     m_perWIPrivateMemSize   = 0;
     m_Context               = const_cast<OpenCLProgramContext*>(ctx);
     m_localOffsetsMap.clear();
@@ -1894,9 +1895,40 @@ bool COpenCLKernel::CompileSIMDSize(SIMDMode simdMode, EmitPass &EP, llvm::Funct
     }
 
     bool compileThisSIMD = CompileThisSIMD(simdMode, EP, F);
-    
+
+    if (CanCompileSIMDInParallel(F))
+    {
+        // The selection is finished by KeepParallelSIMDCompile once the
+        // variants emitted before this one are compiled.
+        m_parallelSIMDSelected = compileThisSIMD;
+        return compileThisSIMD || m_Context->m_DriverInfo.sendMultipleSIMDModes();
+    }
+    return SelectSIMDSize(simdMode, compileThisSIMD);
+}
+
+bool COpenCLKernel::SelectSIMDSize(SIMDMode simdMode, bool compileThisSIMD)
+{
     SIMDMode origSIMDMode = m_Context->getDefaultSIMDMode();
 
+    //With a pre-RA scheduling GRF budget, a SIMD16 kernel that could not be scheduled
+    //under the budget leaves no room for SIMD32, so don't try it. This needs SIMD16 to
+    //be compiled first, as in the ascending order used when sending multiple SIMD modes.
+    unsigned grfBudget = IGC_GET_FLAG_VALUE(VISAPreSchedGRFBudget);
+    if (grfBudget == 0 && IGC_IS_FLAG_ENABLED(EnablePressureFirstPreSched))
+    {
+        grfBudget = m_Context->getNumGRFPerThread();
+    }
+    if (compileThisSIMD && grfBudget != 0 &&
+        simdMode == SIMDMode::SIMD32 && IGC_GET_FLAG_VALUE(ForceOCLSIMDWidth) != 32)
+    {
+        CShader* simd16Shader = m_parent->GetShader(SIMDMode::SIMD16);
+        if (simd16Shader && simd16Shader->ProgramOutput()->m_programSize > 0 &&
+            simd16Shader->m_maxGRFPressure > grfBudget)
+        {
+            compileThisSIMD = false;
+        }
+    }
+
     //if compilation SIMD mode is true then we are guaranteed to compile this mode.
     //Hence set the default compile SIMD mode to the new SIMD configuration
     //Note: This mode is now the default, if compileThisSIMD is false, then we 
@@ -1959,18 +1991,45 @@ bool COpenCLKernel::CompileSIMDSize(SIMDMode simdMode, EmitPass &EP, llvm::Funct
     return compileThisSIMD;
 }
 
-bool COpenCLKernel::CompileThisSIMD(SIMDMode simdMode, EmitPass &EP, llvm::Function &F)
+bool COpenCLKernel::CanCompileSIMDInParallel(llvm::Function &F)
+{
+    // The same conditions hold for all the kernels of the program, so the
+    // background compiles are committed in the same order as a serial build.
+    return (IGC_IS_FLAG_ENABLED(EnableOCLParallelSIMDCompile) ||
+            IGC_IS_FLAG_ENABLED(EnableOCLParallelKernelCompile)) &&
+        m_Context->getModuleMetaData()->csInfo.forcedSIMDModeFromDriver == 0 &&
+        !m_Context->m_instrTypes.hasDebugInfo;
+}
+
+bool COpenCLKernel::KeepParallelSIMDCompile()
+{
+    bool compileThisSIMD = m_parallelSIMDSelected;
+    // Done by CompileThisSIMD when compiling serially
+    if (HasCompiledSIMD() && !m_Context->m_DriverInfo.sendMultipleSIMDModes())
+    {
+        compileThisSIMD = false;
+    }
+    return SelectSIMDSize(m_dispatchSize, compileThisSIMD);
+}
+
+bool COpenCLKernel::HasCompiledSIMD()
 {
     CShader* simd8Program = m_parent->GetShader(SIMDMode::SIMD8);
     CShader* simd16Program = m_parent->GetShader(SIMDMode::SIMD16);
     CShader* simd32Program = m_parent->GetShader(SIMDMode::SIMD32);
+    return (simd8Program && simd8Program->ProgramOutput()->m_programSize > 0) ||
+        (simd16Program && simd16Program->ProgramOutput()->m_programSize > 0) ||
+        (simd32Program && simd32Program->ProgramOutput()->m_programSize > 0);
+}
+
+bool COpenCLKernel::CompileThisSIMD(SIMDMode simdMode, EmitPass &EP, llvm::Function &F)
+{
     CodeGenContext *pCtx = GetContext();
 
-    // Here we see if we have compiled a size for this shader already
-    if((simd8Program && simd8Program->ProgramOutput()->m_programSize > 0) ||
-        (simd16Program && simd16Program->ProgramOutput()->m_programSize > 0) || 
-         (simd32Program && simd32Program->ProgramOutput()->m_programSize > 0))
-        
+    // Here we see if we have compiled a size for this shader already.
+    // With parallel compilation the other sizes are not done yet, the check
+    // is then done by KeepParallelSIMDCompile.
+    if (!CanCompileSIMDInParallel(F) && HasCompiledSIMD())
     {
         if(!pCtx->m_DriverInfo.sendMultipleSIMDModes())
             return false;
@@ -50,6 +50,8 @@ public:
     bool        hasReadWriteImage(llvm::Function &F);
     bool        CompileSIMDSize(SIMDMode simdMode, EmitPass &EP, llvm::Function &F);
     bool        CompileThisSIMD(SIMDMode simdMode, EmitPass &EP, llvm::Function &F);
+    bool        CanCompileSIMDInParallel(llvm::Function &F);
+    bool        KeepParallelSIMDCompile();
 
     void        FillKernel();
 
@@ -111,10 +113,20 @@ protected:
     // Find the sum of inline local sizes used by this kernel
     unsigned int getSumFixedTGSMSizes(llvm::Function* F);
 
+    // Returns true if any SIMD size of this kernel has produced a binary
+    bool HasCompiledSIMD();
+
+    // Updates the default SIMD mode and applies the checks depending on the
+    // SIMD sizes compiled before, returns false if this size is not compiled
+    bool SelectSIMDSize(SIMDMode simdMode, bool compileThisSIMD);
+
     bool m_HasTID;
     bool m_HasGlobalSize;
     bool m_disableMidThreadPreemption;
 
+    // Result of CompileThisSIMD for a parallel compile, see KeepParallelSIMDCompile
+    bool m_parallelSIMDSelected;
+
     // Maps GlobalVariables representing local address-space pointers
     // to their offsets in SLM.
     std::map<llvm::Value*, unsigned int> m_localOffsetsMap;
@@ -140,6 +140,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <llvm/Support/SourceMgr.h>
 #include "common/LLVMWarningsPop.hpp"
 #include <sstream>
+#include <thread>
 
 #include "Compiler/CISACodeGen/PatternMatchPass.hpp"
 #include "Compiler/CISACodeGen/EmitVISAPass.hpp"
@@ -896,10 +897,30 @@ void CodeGen(OpenCLProgramContext *ctx, CShaderProgram::KernelShaderMap &kernels
         AddCodeGenPasses(*ctx, kernels, Passes, SIMDMode::SIMD16, (IGC_GET_FLAG_VALUE(ForceOCLSIMDWidth) != 16));
         AddCodeGenPasses(*ctx, kernels, Passes, SIMDMode::SIMD8, false);
     }
+    // Kernels whose vISA compiles still run after the passes are done
+    std::deque<CShaderProgram*> pendingPrograms;
+    if (IGC_IS_FLAG_ENABLED(EnableOCLParallelKernelCompile))
+    {
+        unsigned maxPendingCompiles = IGC_GET_FLAG_VALUE(OCLParallelCompileThreads);
+        if (maxPendingCompiles == 0)
+        {
+            maxPendingCompiles = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+        Passes.add(new SIMDCompileJoinPass(kernels, pendingPrograms, maxPendingCompiles));
+    }
+    else if (IGC_IS_FLAG_ENABLED(EnableOCLParallelSIMDCompile))
+    {
+        // Wait for the SIMD variants of each kernel compiled in parallel.
+        Passes.add(new SIMDCompileJoinPass(kernels, pendingPrograms, 0));
+    }
     Passes.add(new DebugInfoPass(kernels, SIMDMode::SIMD32));
     Passes.add(new DebugInfoPass(kernels, SIMDMode::SIMD16));
     Passes.add(new DebugInfoPass(kernels, SIMDMode::SIMD8));
     Passes.run(*(ctx->getModule()));
+    for (CShaderProgram* program : pendingPrograms)
+    {
+        SIMDCompileJoinPass::CommitPendingCompiles(program);
+    }
     COMPILER_TIME_END(ctx, TIME_CodeGen);
     DumpLLVMIR(ctx, "codegen");
 }
@@ -108,6 +108,12 @@ public:
     virtual QuadEltUnit GetFinalGlobalOffet(QuadEltUnit globalOffset) { return QuadEltUnit(0); }
     virtual bool hasReadWriteImage(llvm::Function &F) { return false; }
     virtual bool CompileSIMDSize(SIMDMode simdMode, EmitPass &EP, llvm::Function &F) { return true; }
+    /// Returns true if the vISA compile of this SIMD variant may run concurrently with
+    /// the other variants of the kernel (see SIMDCompileJoinPass)
+    virtual bool CanCompileSIMDInParallel(llvm::Function &F) { return false; }
+    /// Called in emission order once the earlier variants are committed, returns false
+    /// if the SIMD selection rules would not have compiled this variant
+    virtual bool KeepParallelSIMDCompile() { return true; }
     CVariable*  LazyCreateCCTupleBackingVariable(
         CoalescingEngine::CCTuple* ccTuple,
         VISA_Type baseType = ISA_TYPE_UD);
@@ -213,6 +219,9 @@ public:
     void        GetPayloadElementSymbols(llvm::Value *inst, CVariable *payload[], int vecWidth);
 
     CodeGenContext*   GetContext() const { return m_ctx; }
+    CShaderProgram*   GetParent() const { return m_parent; }
+    /// Returns true if the function group of this shader has stack calls
+    bool              HasStackCalls() const;
 
     SProgramOutput*   ProgramOutput();
 
@@ -248,6 +257,7 @@ public:
     uint m_staticCycle;
     unsigned m_spillSize = 0;
     float m_spillCost = 0;          // num weighted spill inst / total inst
+    unsigned m_maxGRFPressure = 0;  // max GRF pressure after vISA pre-RA scheduling
 
 	std::vector<llvm::Value*> m_argListCache;
 
@@ -472,6 +482,9 @@ public:
     void FillProgram(SOpenCLProgramInfo* pKernelProgram);
     ShaderStats *m_shaderStats;
 
+    /// SIMD variants whose vISA compile is running in the background, in emission order
+    std::vector<CShader*> m_pendingCompiles;
+
 protected:
     CShader*& GetShaderPtr(SIMDMode simd, ShaderDispatchMode mode);
     CShader* CreateNewShader(SIMDMode simd);
@@ -859,18 +859,17 @@ namespace IGC
         }
 
 
-        void clear()
+        /// Drops the module and the state derived from it, keeping the LLVM context.
+        void clearModule()
         {
-			m_enableSubroutine = false;
-
-            delete modMD;
-            delete m_pMdUtils;
-            modMD = nullptr;
-            m_pMdUtils = nullptr;
+            m_enableSubroutine = false;
+            deleteModule();
+        }
 
-            delete module;
+        void clear()
+        {
+            clearModule();
             llvmCtxWrapper->Release();
-            module = nullptr;
             llvmCtxWrapper = nullptr;
         }
 
@@ -32,15 +32,24 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <llvm/IR/Module.h>
 #include <llvm/IR/Instruction.h>
 #include <llvm/IR/InstIterator.h>
+#include <llvm/ADT/ArrayRef.h>
 #include <llvm/ADT/SmallPtrSet.h>
 #include <llvm/Linker/Linker.h>
 #include <llvm/Transforms/Utils/ValueMapper.h>
 #include <llvm/Transforms/Utils/Cloning.h>
 #include <llvm/Support/Error.h>
+#include <llvm/Support/MD5.h>
 #include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/Support/raw_ostream.h>
 #include "common/LLVMWarningsPop.hpp"
 #include <unordered_set>
 #include <unordered_map>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
 
 using namespace llvm;
 using namespace IGC;
@@ -59,10 +68,12 @@ IGC_INITIALIZE_PASS_END(BIImport, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PA
 
 char BIImport::ID = 0;
 
-BIImport::BIImport(std::unique_ptr<Module> pGenericModule, std::unique_ptr<Module> pSizeModule) :
+BIImport::BIImport(std::unique_ptr<Module> pGenericModule, std::unique_ptr<Module> pSizeModule,
+    const BiFClosureIndexData& closureIndex) :
     ModulePass(ID),
     m_GenericModule(std::move(pGenericModule)),
-    m_SizeModule(std::move(pSizeModule))
+    m_SizeModule(std::move(pSizeModule)),
+    m_ClosureIndex(closureIndex)
 {
     initializeBIImportPass(*PassRegistry::getPassRegistry());
 }
@@ -295,6 +306,237 @@ static bool materialized_use_empty(const Value *v)
     return v->materialized_use_begin() == v->use_end();
 }
 
+namespace {
+    /// Process-wide cache of the built-in closures imported by BIImport.
+    /// Modules belong to the LLVMContext they are read into and every build (and every
+    /// retry of a build) runs in a fresh context, so what is kept here is bitcode: for a
+    /// given set of builtins called by the kernel module, the generic and size_t BiF
+    /// modules after exploring, cleaning and materializing them. Reading that back is
+    /// much cheaper than exploring and materializing the whole lazily loaded library.
+    ///
+    /// A closure is only serialized the second time its key is seen, so programs built
+    /// once do not pay for it. The resident memory is bounded by BiFModuleCacheMaxKB of
+    /// bitcode plus the keys of the last 4 * BiFModuleCacheSize misses.
+    class BiFModuleCache
+    {
+    public:
+        struct Entry
+        {
+            llvm::SmallVector<char, 0> genericBitcode;
+            llvm::SmallVector<char, 0> sizeBitcode;
+            bool hasSizeModule;
+        };
+
+        static BiFModuleCache& get()
+        {
+            static BiFModuleCache cache;
+            return cache;
+        }
+
+        std::shared_ptr<const Entry> lookup(const std::string& key)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_entries.find(key);
+            return it != m_entries.end() ? it->second : nullptr;
+        }
+
+        /// Record a miss for key. Returns true if key missed before, i.e., if its closure
+        /// is worth caching.
+        bool recordMiss(const std::string& key, unsigned maxEntries)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_missed.count(key))
+            {
+                return true;
+            }
+            m_missed.insert(key);
+            m_missOrder.push_back(key);
+            while (m_missOrder.size() > 4 * (size_t)maxEntries)
+            {
+                m_missed.erase(m_missOrder.front());
+                m_missOrder.pop_front();
+            }
+            return false;
+        }
+
+        void insert(const std::string& key, std::shared_ptr<const Entry> entry,
+            unsigned maxEntries, size_t maxBytes)
+        {
+            size_t bytes = key.size() + entry->genericBitcode.size() + entry->sizeBitcode.size();
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (bytes > maxBytes || !m_entries.emplace(key, std::move(entry)).second)
+            {
+                return;
+            }
+            m_order.push_back(key);
+            m_bytes += bytes;
+            while (m_order.size() > maxEntries || m_bytes > maxBytes)
+            {
+                auto it = m_entries.find(m_order.front());
+                m_bytes -= it->first.size() + it->second->genericBitcode.size() +
+                    it->second->sizeBitcode.size();
+                m_entries.erase(it);
+                m_order.pop_front();
+            }
+        }
+
+    private:
+        std::mutex m_mutex;
+        std::unordered_map<std::string, std::shared_ptr<const Entry>> m_entries;
+        std::deque<std::string> m_order;
+        size_t m_bytes = 0;
+        std::unordered_set<std::string> m_missed;
+        std::deque<std::string> m_missOrder;
+    };
+}
+
+namespace {
+    /// Symbol-to-closure index of the BiF library, generated at build time by the ELF packager
+    /// (see WriteClosureIndex there). Each index resource is parsed once per process; the
+    /// names point into the resource, which is never released.
+    class BiFClosureIndex
+    {
+    public:
+        static const BiFClosureIndex* get(const BiFClosureIndexData& data)
+        {
+            static std::mutex mutex;
+            static std::map<const char*, std::unique_ptr<BiFClosureIndex>> indices;
+
+            if (data.Index.empty())
+            {
+                return nullptr;
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            std::unique_ptr<BiFClosureIndex>& pIndex = indices[data.Index.data()];
+            if (pIndex == nullptr)
+            {
+                pIndex.reset(new BiFClosureIndex(data));
+            }
+            return pIndex->m_ids.empty() ? nullptr : pIndex.get();
+        }
+
+        /// Names of the library functions reached from the function called name, itself
+        /// included, or an empty list if the index does not cover it.
+        ArrayRef<StringRef> lookup(StringRef name) const
+        {
+            auto it = m_ids.find(name);
+            if (it == m_ids.end())
+            {
+                return ArrayRef<StringRef>();
+            }
+            unsigned begin = m_begin[it->second];
+            return makeArrayRef(m_members).slice(begin, m_begin[it->second + 1] - begin);
+        }
+
+    private:
+        explicit BiFClosureIndex(const BiFClosureIndexData& indexData)
+        {
+            // The index starts with the MD5 of the generic and the size_t library bitcode it
+            // was generated from. An index from another build of the library is ignored.
+            MD5 hash;
+            hash.update(indexData.GenericBitcode);
+            hash.update(indexData.SizeBitcode);
+            MD5::MD5Result result;
+            hash.final(result);
+            SmallString<32> libraryHash;
+            MD5::stringifyResult(result, libraryHash);
+
+            StringRef line;
+            StringRef data = indexData.Index;
+            std::tie(line, data) = data.split('\n');
+            if (line != libraryHash)
+            {
+                return;
+            }
+
+            unsigned count = 0;
+            std::tie(line, data) = data.split('\n');
+            if (line.getAsInteger(10, count))
+            {
+                return;
+            }
+
+            std::vector<StringRef> names;
+            names.reserve(count);
+            for (unsigned i = 0; i < count; i++)
+            {
+                std::tie(line, data) = data.split('\n');
+                names.push_back(line);
+            }
+
+            m_begin.reserve(count + 1);
+            for (unsigned i = 0; i < count; i++)
+            {
+                m_begin.push_back(m_members.size());
+                std::tie(line, data) = data.split('\n');
+                while (!line.empty())
+                {
+                    StringRef id;
+                    unsigned member = 0;
+                    std::tie(id, line) = line.split(' ');
+                    if (id.getAsInteger(10, member) || member >= count)
+                    {
+                        // Malformed index: import everything by walking the call graph.
+                        m_ids.clear();
+                        return;
+                    }
+                    m_members.push_back(names[member]);
+                }
+                if (m_members.size() != m_begin.back())
+                {
+                    m_ids[names[i]] = i;
+                }
+            }
+            m_begin.push_back(m_members.size());
+        }
+
+        DenseMap<StringRef, unsigned> m_ids;
+        std::vector<unsigned> m_begin;
+        std::vector<StringRef> m_members;
+    };
+}
+
+/// The imported closure depends only on the BiF library and on the builtins directly
+/// called from M, so the data layout (which selects the size_t library) and the sorted
+/// names of the called declarations identify it.
+static std::string GetBuiltinClosureKey(const Module& M, const Module& GenericModule, bool hasSizeModule)
+{
+    std::set<StringRef> roots;
+    for (auto &F : M)
+    {
+        for (const_inst_iterator it = inst_begin(F), e = inst_end(F); it != e; ++it)
+        {
+            const CallInst *pInstCall = dyn_cast<CallInst>(&*it);
+            const Function *pCalledFunc = pInstCall ? pInstCall->getCalledFunction() : nullptr;
+            if (pCalledFunc && pCalledFunc->isDeclaration() && !pCalledFunc->isIntrinsic())
+            {
+                roots.insert(pCalledFunc->getName());
+            }
+        }
+    }
+
+    std::string key = GenericModule.getDataLayoutStr();
+    key += hasSizeModule ? "|size_t" : "|generic";
+    for (auto name : roots)
+    {
+        key += '\n';
+        key += name;
+    }
+    return key;
+}
+
+static std::unique_ptr<Module> ParseCachedBuiltins(const SmallVectorImpl<char>& bitcode, LLVMContext& context)
+{
+    llvm::Expected<std::unique_ptr<llvm::Module>> ModuleOrErr =
+        llvm::parseBitcodeFile(MemoryBufferRef(StringRef(bitcode.data(), bitcode.size()), "BIF"), context);
+    if (llvm::Error EC = ModuleOrErr.takeError())
+    {
+        consumeError(std::move(EC));
+        return nullptr;
+    }
+    return std::move(*ModuleOrErr);
+}
+
 void BIImport::WriteElfHeaderToMap(DenseMap<StringRef, int> &Map, char* pData, size_t dataSize)
 {
     //Data from pData is layed out as follows.....
@@ -482,47 +724,49 @@ std::unique_ptr<llvm::Module> BIImport::Construct(Module &M, CLElfLib::CElfReade
     return BIM;
 }
 
-bool BIImport::runOnModule(Module &M)
+void BIImport::MaterializeBuiltins(Module &M)
 {
-    if (m_GenericModule == nullptr)
-    {
-        return false;
-    }
+    const BiFClosureIndex* pIndex = IGC_IS_FLAG_ENABLED(DisableBiFClosureIndex) ?
+        nullptr : BiFClosureIndex::get(m_ClosureIndex);
 
-
-    for (auto &F : M)
+    // Materialize the indexed closure of a builtin. Nothing is materialized if a member
+    // cannot be found, so an index that does not match the library only costs the walk.
+    TFunctionsVec closure;
+    auto MaterializeClosure = [&](StringRef funcName) -> bool
     {
-        if (F.isDeclaration())
+        ArrayRef<StringRef> names = pIndex ? pIndex->lookup(funcName) : ArrayRef<StringRef>();
+        if (names.empty())
         {
-            auto FuncName = F.getName();
-            std::string NewFuncName = "";
-
-            std::string ReplaceStr = FuncName.slice(2, FuncName.size()).str();
-            if (MangleStr.find(ReplaceStr) != MangleStr.end())
-            {
-                NewFuncName = "_Z" + MangleStr[ReplaceStr];
-            }
-            else if (isMangledImageFn(FuncName, MangleSubst))
+            return false;
+        }
+        closure.clear();
+        for (auto name : names)
+        {
+            Function* pFunc = GetBuiltinFunction2(name);
+            if (!pFunc)
             {
-                NewFuncName = updateSPIRmangleName(FuncName, MangleSubst);
+                return false;
             }
-            else
+            closure.push_back(pFunc);
+        }
+        for (auto *pFunc : closure)
+        {
+            if (!pFunc->isMaterializable())
             {
-                NewFuncName = FuncName;
+                continue;
             }
-            // Current workaround to support binaries compiled with < 3.8 clang
-            // This is for dealing with constant (K) and volatile (V) types
-            if (NewFuncName.find("V") != std::string::npos)
-            {
-                NewFuncName = updateSPIRmangleName38_to_40(NewFuncName, 'V');
+            if (Error Err = pFunc->materialize()) {
+                handleAllErrors(std::move(Err), [&](ErrorInfoBase &EIB) {
+                    errs() << "===> Materialize Failure: " << EIB.message().c_str() << '\n';
+                });
+                assert(0 && "Failed to materialize Global Variables");
             }
-            else if (NewFuncName.find("K") != std::string::npos)
-            {
-                NewFuncName = updateSPIRmangleName38_to_40(NewFuncName, 'K');
+            else {
+                pFunc->addAttribute(AttributeSet::FunctionIndex, llvm::Attribute::Builtin);
             }
-            F.setName(NewFuncName);
         }
-    }
+        return true;
+    };
 
     std::function<void(Function*)> Explore = [&](Function *pRoot) -> void
     {
@@ -535,6 +779,7 @@ bool BIImport::runOnModule(Module &M)
             if (pCallee->isDeclaration())
             {
                 auto funcName = pCallee->getName();
+                if (MaterializeClosure(funcName)) continue;
                 Function* pSrcFunc = GetBuiltinFunction2(funcName);
                 if (!pSrcFunc) continue;
                 pFunc = pSrcFunc;
@@ -583,17 +828,10 @@ bool BIImport::runOnModule(Module &M)
     };
 
     CleanUnused(m_GenericModule.get());
-    Linker ld(M);
-
     if (Error err = m_GenericModule->materializeAll()) {
         assert(0 && "materializeAll failed for generic builtin module");
     }
 
-    if (ld.linkInModule(std::move(m_GenericModule)))
-    {
-        assert(0 && "Error linking generic builtin module");
-    }
-
     if (m_SizeModule)
     {
         CleanUnused(m_SizeModule.get());
@@ -601,7 +839,105 @@ bool BIImport::runOnModule(Module &M)
         {
             assert(0 && "materializeAll failed for size_t builtin module");
         }
+    }
+}
+
+bool BIImport::runOnModule(Module &M)
+{
+    if (m_GenericModule == nullptr)
+    {
+        return false;
+    }
+
+
+    for (auto &F : M)
+    {
+        if (F.isDeclaration())
+        {
+            auto FuncName = F.getName();
+            std::string NewFuncName = "";
 
+            std::string ReplaceStr = FuncName.slice(2, FuncName.size()).str();
+            if (MangleStr.find(ReplaceStr) != MangleStr.end())
+            {
+                NewFuncName = "_Z" + MangleStr[ReplaceStr];
+            }
+            else if (isMangledImageFn(FuncName, MangleSubst))
+            {
+                NewFuncName = updateSPIRmangleName(FuncName, MangleSubst);
+            }
+            else
+            {
+                NewFuncName = FuncName;
+            }
+            // Current workaround to support binaries compiled with < 3.8 clang
+            // This is for dealing with constant (K) and volatile (V) types
+            if (NewFuncName.find("V") != std::string::npos)
+            {
+                NewFuncName = updateSPIRmangleName38_to_40(NewFuncName, 'V');
+            }
+            else if (NewFuncName.find("K") != std::string::npos)
+            {
+                NewFuncName = updateSPIRmangleName38_to_40(NewFuncName, 'K');
+            }
+            F.setName(NewFuncName);
+        }
+    }
+
+    // Reuse the closure imported by an earlier build that called the same builtins.
+    const unsigned cacheSize = IGC_GET_FLAG_VALUE(BiFModuleCacheSize);
+    std::string closureKey;
+    std::shared_ptr<const BiFModuleCache::Entry> cached;
+    if (cacheSize != 0)
+    {
+        closureKey = GetBuiltinClosureKey(M, *m_GenericModule, m_SizeModule != nullptr);
+        cached = BiFModuleCache::get().lookup(closureKey);
+    }
+
+    std::unique_ptr<Module> cachedGeneric, cachedSize;
+    if (cached)
+    {
+        cachedGeneric = ParseCachedBuiltins(cached->genericBitcode, M.getContext());
+        if (cached->hasSizeModule)
+        {
+            cachedSize = ParseCachedBuiltins(cached->sizeBitcode, M.getContext());
+        }
+    }
+
+    if (cachedGeneric && (cachedSize || !cached->hasSizeModule))
+    {
+        m_GenericModule = std::move(cachedGeneric);
+        m_SizeModule = std::move(cachedSize);
+    }
+    else
+    {
+        MaterializeBuiltins(M);
+
+        if (cacheSize != 0 && BiFModuleCache::get().recordMiss(closureKey, cacheSize))
+        {
+            auto entry = std::make_shared<BiFModuleCache::Entry>();
+            raw_svector_ostream genericOS(entry->genericBitcode);
+            WriteBitcodeToFile(m_GenericModule.get(), genericOS);
+            entry->hasSizeModule = (m_SizeModule != nullptr);
+            if (m_SizeModule)
+            {
+                raw_svector_ostream sizeOS(entry->sizeBitcode);
+                WriteBitcodeToFile(m_SizeModule.get(), sizeOS);
+            }
+            BiFModuleCache::get().insert(closureKey, std::move(entry), cacheSize,
+                (size_t)IGC_GET_FLAG_VALUE(BiFModuleCacheMaxKB) * 1024);
+        }
+    }
+
+    Linker ld(M);
+
+    if (ld.linkInModule(std::move(m_GenericModule)))
+    {
+        assert(0 && "Error linking generic builtin module");
+    }
+
+    if (m_SizeModule)
+    {
         if (ld.linkInModule(std::move(m_SizeModule)))
         {
             assert(0 && "Error linking size_t builtin module");
@@ -815,9 +1151,10 @@ void BIImport::InitializeBIFlags(Module &M)
 
 extern "C" llvm::ModulePass *createBuiltInImportPass(
     std::unique_ptr<Module> pGenericModule,
-    std::unique_ptr<Module> pSizeModule)
+    std::unique_ptr<Module> pSizeModule,
+    const BiFClosureIndexData& closureIndex)
 {
-    return new BIImport(std::move(pGenericModule), std::move(pSizeModule));
+    return new BIImport(std::move(pGenericModule), std::move(pSizeModule), closureIndex);
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////
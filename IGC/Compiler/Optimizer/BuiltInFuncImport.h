@@ -40,6 +40,15 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 namespace IGC
 {
+    /// The builtin closure index generated with the BiF library by the ELF packager, and the
+    /// bitcode of the generic and size_t modules it has to match.
+    struct BiFClosureIndexData
+    {
+        llvm::StringRef Index;
+        llvm::StringRef GenericBitcode;
+        llvm::StringRef SizeBitcode;
+    };
+
     /// This pass imports built-in functions from source module to destination module.
     class BIImport : public llvm::ModulePass
     {
@@ -52,8 +61,11 @@ namespace IGC
         static char ID;
 
         /// @brief Constructor
+        /// @param closureIndex The builtin closure index generated with the BiF library for
+        ///        this size_t module, if any. The buffers must outlive the pass.
         BIImport(std::unique_ptr<llvm::Module> pGenericModule = nullptr,
-            std::unique_ptr<llvm::Module> pSizeModule = nullptr);
+            std::unique_ptr<llvm::Module> pSizeModule = nullptr,
+            const BiFClosureIndexData& closureIndex = BiFClosureIndexData());
 
         /// @brief analyses used
         virtual void getAnalysisUsage(llvm::AnalysisUsage &AU) const override
@@ -81,6 +93,11 @@ namespace IGC
         /// @param [OUT] calledFuncs The list of all functions called by pFunc.
         static void GetCalledFunctions(const llvm::Function* pFunc, TFunctionsVec& calledFuncs);
 
+        /// @brief Materialize the builtins called by M, along with their callees, and drop
+        ///        everything else from the builtin modules. Builtins found in the closure
+        ///        index are materialized with their whole closure without walking it.
+        void MaterializeBuiltins(llvm::Module &M);
+
         /// @brief  Remove function bitcasts that sometimes may appear due to the changed in the way
         ///         the BiFs are linked. We can remove this code once llvm implements typeless pointers.
         void removeFunctionBitcasts(llvm::Module &M);
@@ -101,12 +118,15 @@ namespace IGC
         /// Builtin module - contains the source function definition to import
 		std::unique_ptr<llvm::Module> m_GenericModule;
         std::unique_ptr<llvm::Module> m_SizeModule;
+        /// Symbol-to-closure index of the builtin modules (empty if there is none)
+        BiFClosureIndexData m_ClosureIndex;
     };
 
 } // namespace IGC
 
 extern "C" llvm::ModulePass *createBuiltInImportPass(
-    std::unique_ptr<llvm::Module> pGenericModule, std::unique_ptr<llvm::Module> pSizeModule);
+    std::unique_ptr<llvm::Module> pGenericModule, std::unique_ptr<llvm::Module> pSizeModule,
+    const IGC::BiFClosureIndexData& closureIndex = IGC::BiFClosureIndexData());
 
 namespace IGC
 {
@@ -41,9 +41,12 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Function.h"
+#include "llvm/IR/InstIterator.h"
+#include "llvm/IR/Instructions.h"
 #include "llvm/IRReader/IRReader.h"
 #include "llvm/IR/LegacyPassManager.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MD5.h"
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/PrettyStackTrace.h"
 #include "llvm/Transforms/IPO.h"
@@ -69,6 +72,8 @@ static cl::opt<std::string>
 	OutputPath(cl::Positional, cl::desc("<output .llvm file>"), cl::init("-"));
 static cl::opt<bool>
 	IncludeSizet("includeSizet", cl::desc("if the module has size_t"));
+static cl::opt<std::string>
+	ClosureIndexSizet("closureIndex", cl::desc("<size_t .bc file> write the builtin closure index of the input and size_t modules"));
 
 void MakeHeader(StringRef Func, SmallVector<char, 0> &headerVector, int index)
 {
@@ -98,6 +103,110 @@ void CreateElfSection(CLElfLib::CElfWriter* pWriter, CLElfLib::SSectionNode sect
 }
 
 
+// Writes the index BIImport uses to import a builtin without walking its call graph: for every
+// non-local function defined in the generic or the size_t library, the library functions it
+// reaches through direct calls, itself included. A call to a declaration resolves to the
+// generic library first, as in BIImport::GetBuiltinFunction2. The index is text:
+//     <number of functions>
+//     one function name per line
+//     one line per function with the space separated indices of its closure
+// The closure line is left empty for local functions and for functions whose closure has a
+// name that does not lead back to the same definition; BIImport walks those as before.
+// The index is preceded by the MD5 of the generic and the size_t bitcode, in that order, which
+// BIImport checks before it trusts the index.
+static int WriteClosureIndex(Module &Generic, Module &Sizet, StringRef GenericBitcode,
+    StringRef SizetBitcode, const std::string &OutputFile)
+{
+    auto Lookup = [&](StringRef Name) -> Function*
+    {
+        for (Module *pM : { &Generic, &Sizet })
+        {
+            Function *pFunc = pM->getFunction(Name);
+            if (pFunc && !pFunc->isDeclaration())
+                return pFunc;
+        }
+        return nullptr;
+    };
+
+    std::vector<Function*> Funcs;
+    DenseMap<const Function*, unsigned> Ids;
+    for (Module *pM : { &Generic, &Sizet })
+    {
+        for (auto &F : *pM)
+        {
+            if (!F.isDeclaration())
+            {
+                Ids[&F] = Funcs.size();
+                Funcs.push_back(&F);
+            }
+        }
+    }
+
+    std::vector<std::vector<unsigned>> Callees(Funcs.size());
+    for (unsigned i = 0; i < Funcs.size(); i++)
+    {
+        SmallPtrSet<Function*, 8> Visited;
+        for (auto &I : instructions(Funcs[i]))
+        {
+            auto *pCall = dyn_cast<CallInst>(&I);
+            Function *pCallee = pCall ? pCall->getCalledFunction() : nullptr;
+            if (!pCallee || !Visited.insert(pCallee).second)
+                continue;
+            Function *pFunc = pCallee->isDeclaration() ? Lookup(pCallee->getName()) : pCallee;
+            if (pFunc)
+                Callees[i].push_back(Ids[pFunc]);
+        }
+    }
+
+    MD5 Hash;
+    Hash.update(GenericBitcode);
+    Hash.update(SizetBitcode);
+    MD5::MD5Result HashResult;
+    Hash.final(HashResult);
+    SmallString<32> LibraryHash;
+    MD5::stringifyResult(HashResult, LibraryHash);
+
+    std::string Index;
+    raw_string_ostream OS(Index);
+    OS << LibraryHash << '\n';
+    OS << Funcs.size() << '\n';
+    for (auto *pFunc : Funcs)
+        OS << pFunc->getName() << '\n';
+
+    std::vector<unsigned> Stamp(Funcs.size(), ~0u);
+    std::vector<unsigned> Closure;
+    for (unsigned Root = 0; Root < Funcs.size(); Root++)
+    {
+        if (!Funcs[Root]->hasLocalLinkage())
+        {
+            bool Named = true;
+            Closure.assign(1, Root);
+            Stamp[Root] = Root;
+            for (size_t i = 0; i < Closure.size(); i++)
+            {
+                Function *pFunc = Funcs[Closure[i]];
+                Named &= (Lookup(pFunc->getName()) == pFunc);
+                for (unsigned Callee : Callees[Closure[i]])
+                {
+                    if (Stamp[Callee] != Root)
+                    {
+                        Stamp[Callee] = Root;
+                        Closure.push_back(Callee);
+                    }
+                }
+            }
+            for (size_t i = 0; Named && i < Closure.size(); i++)
+                OS << (i ? " " : "") << Closure[i];
+        }
+        OS << '\n';
+    }
+    OS.flush();
+
+    std::ofstream ofs(OutputFile, std::ofstream::binary);
+    ofs.write(Index.data(), Index.size());
+    return ofs.good() ? 0 : -1;
+}
+
 std::unique_ptr<Module> LocalCloneModule(
 	const Module *M, ValueToValueMapTy &VMap,
     std::vector<GlobalValue*> &ExtractValues,
@@ -237,6 +346,28 @@ int main(int argc, char *argv[])
         return -1;
     }
 
+    if (!ClosureIndexSizet.empty())
+    {
+        ErrorOr<std::unique_ptr<MemoryBuffer>> SizetFileOrErr =
+            MemoryBuffer::getFile(ClosureIndexSizet);
+        if (!SizetFileOrErr)
+        {
+            errs() << "closure-index-sizet: unable to read " << ClosureIndexSizet << '\n';
+            return -1;
+        }
+        std::unique_ptr<MemoryBuffer> sizetBufferPtr = std::move(SizetFileOrErr.get());
+        Expected<std::unique_ptr<Module>> M_sizet =
+            llvm::parseBitcodeFile(sizetBufferPtr->getMemBufferRef(), Context);
+        if (llvm::Error EC = M_sizet.takeError())
+        {
+            Err.print("closure-index-sizet", errs());
+            return -1;
+        }
+        CLElfLib::CElfWriter::Delete(pWriter);
+        return WriteClosureIndex(*M.get(), *M_sizet.get(), genericBufferPtr->getBuffer(),
+            sizetBufferPtr->getBuffer(), OutputPath);
+    }
+
 	auto &Bif_FunctionList = M.get()->getFunctionList();
 	auto &GlobalList = M.get()->getGlobalList();
 	std::vector<GlobalValue*> NotFound;
@@ -38,6 +38,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "common/LLVMWarningsPop.hpp"
 
 #include "common/secure_string.h"
+#include "CompileTrace.h"
 #include <fstream>
 #include <algorithm> 
 #include <iomanip>
@@ -559,6 +560,7 @@ TimeStats::TimeStats()
     std::fill(std::begin(m_wallclockStart), std::end(m_wallclockStart), 0);
     std::fill(std::begin(m_elapsedTime),    std::end(m_elapsedTime),    0);
     std::fill(std::begin(m_hitCount),       std::end(m_hitCount),       0);
+    std::fill(std::begin(m_traceStart),     std::end(m_traceStart),     0);
     m_freq = iSTD::GetTimestampFrequency();
 }
 
@@ -575,6 +577,7 @@ void TimeStats::recordTimerStart( COMPILE_TIME_INTERVALS compileInterval )
 {
     assert( compileInterval >= 0 && compileInterval < MAX_COMPILE_TIME_INTERVALS );
     m_wallclockStart[ compileInterval ] = iSTD::GetTimestampCounter();
+    m_traceStart[ compileInterval ] = IsCompileTraceEnabled() ? GetCompileTraceTime() : 0;
 }
 
 void TimeStats::recordTimerEnd( COMPILE_TIME_INTERVALS compileInterval )
@@ -582,6 +585,11 @@ void TimeStats::recordTimerEnd( COMPILE_TIME_INTERVALS compileInterval )
     assert( compileInterval >= 0 && compileInterval < MAX_COMPILE_TIME_INTERVALS );
     m_elapsedTime[ compileInterval ] += iSTD::GetTimestampCounter() - m_wallclockStart[ compileInterval ];
     m_hitCount[ compileInterval ]++;
+    if( m_traceStart[ compileInterval ] != 0 )
+    {
+        RecordCompileTraceSpan( g_cCompTimeIntervals[ compileInterval ], m_traceStart[ compileInterval ], GetCompileTraceTime() );
+        m_traceStart[ compileInterval ] = 0;
+    }
 }
 
 uint64_t TimeStats::getCompileTime( COMPILE_TIME_INTERVALS compileInterval ) const
@@ -268,6 +268,7 @@ private:
     uint64_t m_wallclockStart[MAX_COMPILE_TIME_INTERVALS];   //!< Most recent starting time of the timer
     uint64_t m_elapsedTime[MAX_COMPILE_TIME_INTERVALS];      //!< Running total of time measured by the timer
     uint64_t m_hitCount[MAX_COMPILE_TIME_INTERVALS];         //!< Number of times a timer was started
+    uint64_t m_traceStart[MAX_COMPILE_TIME_INTERVALS];       //!< Start of the compile trace span of the timer, 0 if not traced
     uint64_t m_freq;
 };
 
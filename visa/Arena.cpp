@@ -26,6 +26,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "Arena.h"
 
+#include <map>
+
 #ifdef COLLECT_ALLOCATION_STATS
 int numAllocations = 0;
 int numMallocCalls = 0;
@@ -34,8 +36,118 @@ int totalMallocSize = 0;
 int numMemManagers = 0;
 int maxArenaLength = 0;
 int currentMallocSize = 0;
+int peakMallocSize = 0;
+int numArenaReuses = 0;
+int currentPooledSize = 0;
+int peakPooledSize = 0;
+int numRecycledAllocations = 0;
 #endif
 using namespace vISA;
+
+namespace
+{
+    // Free arenas of one thread, chained through their headers and bucketed
+    // by data size. Its destructor returns them to the heap on thread exit.
+    struct ArenaPool
+    {
+        // Upper bound on the memory kept around between compilations.
+        static const size_t MaxPooledSize = 16 * 1024 * 1024;
+
+        std::map<size_t, unsigned char*> arenas;
+        size_t pooledSize = 0;
+
+        ~ArenaPool();
+    };
+
+#ifndef ANDROID
+    // A plain pointer is used so that ArenaManagers destroyed after the pool
+    // (e.g., statics on the main thread) fall back to freeing their arenas.
+    thread_local ArenaPool* threadArenaPool = NULL;
+    struct ArenaPoolOwner
+    {
+        ArenaPool pool;
+        ArenaPoolOwner() { threadArenaPool = &pool; }
+        ~ArenaPoolOwner() { threadArenaPool = NULL; }
+    };
+    thread_local ArenaPoolOwner threadArenaPoolOwner;
+#endif
+
+    ArenaPool* getArenaPool()
+    {
+#ifndef ANDROID
+        // touch the owner so that it is constructed on first use
+        (void)threadArenaPoolOwner;
+        return threadArenaPool;
+#else
+        return NULL;
+#endif
+    }
+
+    unsigned char*& nextPooledArena(unsigned char* arena)
+    {
+        return *(unsigned char**)arena;
+    }
+
+    ArenaPool::~ArenaPool()
+    {
+        for (auto& entry : arenas)
+        {
+            unsigned char* arena = entry.second;
+            while (arena)
+            {
+                unsigned char* next = nextPooledArena(arena);
+                delete [] arena;
+                arena = next;
+            }
+        }
+    }
+}
+
+unsigned char*
+ArenaManager::TakePooledArena(size_t dataSize)
+{
+    ArenaPool* pool = getArenaPool();
+    if (pool == NULL)
+    {
+        return NULL;
+    }
+    auto it = pool->arenas.find(dataSize);
+    if (it == pool->arenas.end() || it->second == NULL)
+    {
+        return NULL;
+    }
+    unsigned char* arena = it->second;
+    it->second = nextPooledArena(arena);
+    pool->pooledSize -= dataSize;
+#ifdef COLLECT_ALLOCATION_STATS
+    numArenaReuses++;
+    currentPooledSize -= (int)dataSize;
+#endif
+    return arena;
+}
+
+bool
+ArenaManager::PoolArena(unsigned char* arena, size_t dataSize)
+{
+    ArenaPool* pool = getArenaPool();
+    if (pool == NULL || pool->pooledSize + dataSize > ArenaPool::MaxPooledSize)
+    {
+        return false;
+    }
+    unsigned char*& head = pool->arenas[dataSize];
+    nextPooledArena(arena) = head;
+    head = arena;
+    pool->pooledSize += dataSize;
+#ifdef COLLECT_ALLOCATION_STATS
+    currentPooledSize += (int)dataSize;
+    if (currentPooledSize > peakPooledSize)
+    {
+        peakPooledSize = currentPooledSize;
+    }
+#endif
+    return true;
+}
+
 void*
 ArenaHeader::AllocSpace (size_t size)
 {
@@ -71,8 +183,17 @@ ArenaManager::FreeArenas()
         currentMallocSize -= _arenas->size;
 #endif
 		unsigned char* killed = (unsigned char*) _arenas;
+		size_t killedSize = _arenas->size;
 		_arenas = _arenas->_nextArena;
-		delete [] killed;
+		if (killedSize != ArenaHeader::WordAlign(_defaultArenaSize) || !PoolArena(killed, killedSize))
+		{
+			delete [] killed;
+		}
+	}
+
+	for (unsigned i = 0; i < NumSizeClasses; i++)
+	{
+		_freeLists[i] = NULL;
 	}
 
 	_arenas = 0;
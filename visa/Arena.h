@@ -47,6 +47,11 @@ extern int totalMallocSize;
 extern int numMemManagers;
 extern int maxArenaLength;
 extern int currentMallocSize;
+extern int peakMallocSize;
+extern int numArenaReuses;
+extern int currentPooledSize;
+extern int peakPooledSize;
+extern int numRecycledAllocations;
 #endif
 
 namespace vISA
@@ -123,6 +128,10 @@ namespace vISA
             _arenas(0),
             _defaultArenaSize(defaultArenaSize)
         {
+            for (unsigned i = 0; i < NumSizeClasses; i++)
+            {
+                _freeLists[i] = NULL;
+            }
             CreateArena(_defaultArenaSize);
         }
 
@@ -142,6 +151,17 @@ namespace vISA
 
             if (size)
             {
+                size_t sizeClass = GetSizeClass(size);
+                if (sizeClass < NumSizeClasses && _freeLists[sizeClass])
+                {
+                    FreeBlock* block = _freeLists[sizeClass];
+                    _freeLists[sizeClass] = block->next;
+#ifdef COLLECT_ALLOCATION_STATS
+                    numRecycledAllocations++;
+#endif
+                    return block;
+                }
+
                 space = _arenas->AllocSpace(size);
 
                 if (space == 0)
@@ -161,12 +181,35 @@ namespace vISA
             return space;
         }
 
+        // Return a block obtained from AllocDataSpace to the free list of its
+        // size class. Blocks that are too small or too large are not recycled.
+        void FreeDataSpace(void* space, size_t size)
+        {
+#if !defined(NDEBUG) && defined(vISA_DEBUG_MEM_ALLOC)
+            return;
+#endif
+            size_t sizeClass = GetSizeClass(size);
+            if (space && size >= sizeof(FreeBlock) && sizeClass < NumSizeClasses)
+            {
+                FreeBlock* block = (FreeBlock*)space;
+                block->next = _freeLists[sizeClass];
+                _freeLists[sizeClass] = block;
+            }
+        }
+
         ArenaHeader* CreateArena(size_t size)
         {
             size_t arenaDataSize = (size > _defaultArenaSize) ? size : _defaultArenaSize;
             arenaDataSize = ArenaHeader::WordAlign(arenaDataSize);
-            unsigned char * arena =
-                new unsigned char[ArenaHeader::GetArenaSize(arenaDataSize)];
+            unsigned char * arena = TakePooledArena(arenaDataSize);
+            if (arena == NULL)
+            {
+                arena = new unsigned char[ArenaHeader::GetArenaSize(arenaDataSize)];
+#ifdef COLLECT_ALLOCATION_STATS
+                numMallocCalls++;
+                totalMallocSize += arenaDataSize;
+#endif
+            }
 
             ArenaHeader* newArena = new (arena)ArenaHeader(arenaDataSize, _arenas);
             // Add new arena to the head of queue
@@ -179,9 +222,11 @@ namespace vISA
             _arenas = newArena;
 
 #ifdef COLLECT_ALLOCATION_STATS
-            numMallocCalls++;
-            totalMallocSize += arenaDataSize;
             currentMallocSize += arenaDataSize;
+            if (currentMallocSize > peakMallocSize)
+            {
+                peakMallocSize = currentMallocSize;
+            }
             int numArenas = 0;
             for( ArenaHeader *tmpArena = _arenas; tmpArena != NULL; tmpArena = tmpArena->_nextArena )
             {
@@ -202,10 +247,31 @@ namespace vISA
 
         void FreeArenas();
 
+        // Arenas of the default size are kept in a per-thread pool when they
+        // are freed and handed out again to the next ArenaManager asking for
+        // that size, so that back to back compilations and RA iterations do
+        // not go back to malloc for every arena.
+        static unsigned char* TakePooledArena(size_t dataSize);
+        static bool PoolArena(unsigned char* arena, size_t dataSize);
+
+        // Size classes of the recycled blocks, in words. Only small blocks
+        // (e.g., list nodes) are worth recycling.
+        struct FreeBlock
+        {
+            FreeBlock* next;
+        };
+        static const unsigned NumSizeClasses = 17;
+
+        static size_t GetSizeClass(size_t size)
+        {
+            return ArenaHeader::WordAlign(size) >> 2;
+        }
+
         // Data
 
         ArenaHeader * _arenas;
         const size_t  _defaultArenaSize;
+        FreeBlock*    _freeLists[NumSizeClasses];
     };
 }
 #endif
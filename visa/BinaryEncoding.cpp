@@ -2802,6 +2802,47 @@ BinaryEncoding::Status BinaryEncoding::DoAllEncoding(G4_INST* inst)
 //    }
 //}
 
+void BinaryEncoding::InitCompactionTables()
+{
+    for ( uint8_t i=0; i<(int)COMPACT_TABLE_SIZE; i++ )
+    {
+        BDWCompactControlTable.AddIndex(IVBCompactControlTable[i], i);
+        BDWCompactSourceTable.AddIndex(IVBCompactSourceTable[i], i);
+        BDWCompactSubRegTable.AddIndex(IVBCompactSubRegTable[i], i);
+        BDWCompactSubRegTable.AddIndex1(IVBCompactSubRegTable[i] & 0x1F, i);
+        BDWCompactSubRegTable.AddIndex2(IVBCompactSubRegTable[i] & 0x3FF, i);
+        BDWCompactDataTypeTableStr.AddIndex(BDWCompactDataTypeTable[i], i);
+    }
+}
+
+BinaryEncoding::Status BinaryEncoding::EncodeInstruction(G4_INST* inst)
+{
+    BinInst *bin = new (mem) BinInst();
+    inst->setBinInst(bin);
+
+    Status myStatus = DoAllEncoding(inst);
+
+    if (inst->opcode() == G4_nop)
+    {
+        return myStatus;
+    }
+
+    EncodeOperandDst(inst);
+
+    if ( !EncodingHelper::hasLabelString(inst) )
+    {
+        EncodeOperands(inst);
+    }
+
+    if(inst->opcode() == G4_pseudo_fc_call ||
+        inst->opcode() == G4_pseudo_fc_ret)
+    {
+        inst->getBinInst()->SetDontCompactFlag(true);
+    }
+
+    return myStatus;
+}
+
 inline BinaryEncoding::Status BinaryEncoding::ProduceBinaryInstructions()
 {
     Status myStatus = FAILURE;
@@ -2816,15 +2857,7 @@ inline BinaryEncoding::Status BinaryEncoding::ProduceBinaryInstructions()
 
     if (doCompaction())
     {
-        for ( uint8_t i=0; i<(int)COMPACT_TABLE_SIZE; i++ )
-        {
-            BDWCompactControlTable.AddIndex(IVBCompactControlTable[i], i);
-            BDWCompactSourceTable.AddIndex(IVBCompactSourceTable[i], i);
-            BDWCompactSubRegTable.AddIndex(IVBCompactSubRegTable[i], i);
-            BDWCompactSubRegTable.AddIndex1(IVBCompactSubRegTable[i] & 0x1F, i);
-            BDWCompactSubRegTable.AddIndex2(IVBCompactSubRegTable[i] & 0x3FF, i);
-            BDWCompactDataTypeTableStr.AddIndex(BDWCompactDataTypeTable[i], i);
-        }
+        InitCompactionTables();
     }
 
      /**
@@ -2852,11 +2885,7 @@ inline BinaryEncoding::Status BinaryEncoding::ProduceBinaryInstructions()
             }
             else
             {
-                BinInst *bin = new (mem) BinInst();
-                inst->setBinInst(bin);
-
-                myStatus = DoAllEncoding(inst);
-
+                myStatus = EncodeInstruction(inst);
 
                 if (inst->opcode() == G4_nop )
                 {
@@ -2866,20 +2895,6 @@ inline BinaryEncoding::Status BinaryEncoding::ProduceBinaryInstructions()
                     continue;
                 }
 
-
-                EncodeOperandDst(inst);
-
-                if ( !EncodingHelper::hasLabelString(inst) )
-                {
-                    EncodeOperands(inst);
-                }
-
-                if(inst->opcode() == G4_pseudo_fc_call ||
-                    inst->opcode() == G4_pseudo_fc_ret)
-                {
-                    inst->getBinInst()->SetDontCompactFlag(true);
-                }
-
                 if (doCompaction())
                 {
                     inst->getBinInst()->SetMustCompactFlag(false);
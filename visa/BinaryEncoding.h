@@ -789,6 +789,14 @@ namespace vISA
 
         Status ProduceBinaryInstructions();
 
+        // Fills the index maps compactOneInstruction() looks the fields up in.
+        void InitCompactionTables();
+
+        // Encodes inst into a new uncompacted BinInst attached to it. Branch
+        // offsets are not set, ProduceBinaryInstructions() patches them in once
+        // the labels are placed.
+        Status EncodeInstruction(G4_INST* inst);
+
         //Status commitLabels();
         //Status CommitRelativeAddresses();
 
@@ -28,6 +28,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "GTGPU_RT_ASM_Interface.h"
 #include "iga/IGALibrary/api/igaEncoderWrapper.hpp"
 #include "Timer.h"
+#include <cstring>
+#include <type_traits>
 
 using namespace iga;
 using namespace vISA;
@@ -413,6 +415,40 @@ iga::Op BinaryEncodingIGA::getIGAOp(G4_opcode op, G4_INST *inst) const
 void BinaryEncodingIGA::DoAll()
 {
     FixInst();
+
+    if (m_kernelBuffer)
+    {
+        m_kernelBufferSize = 0;
+        delete static_cast<uint8_t*>(m_kernelBuffer);
+        m_kernelBuffer = nullptr;
+    }
+
+    // both paths leave the binary in the IGA kernel's memory
+    void* bits = nullptr;
+    uint32_t bitsLen = 0;
+    if (kernel.getOption(vISA_StreamEncode) && !kernel.getOption(vISA_CheckStreamEncode))
+    {
+        encodeStreamed(bits, bitsLen);
+    }
+    else
+    {
+        encodeWithIGAKernel(bits, bitsLen);
+        if (kernel.getOption(vISA_CheckStreamEncode))
+        {
+            checkStreamEncode(bits, bitsLen);
+        }
+    }
+
+    kernel.setAsmCount(IGAInstId);
+
+    m_kernelBufferSize = bitsLen;
+    m_kernelBuffer = allocCodeBlock(m_kernelBufferSize);
+    memcpy_s(m_kernelBuffer, m_kernelBufferSize, bits, m_kernelBufferSize);
+}
+
+// Builds the IGA IR kernel for the whole G4 kernel and encodes it.
+void BinaryEncodingIGA::encodeWithIGAKernel(void*& bits, uint32_t& bitsLen)
+{
     Block* currBB = nullptr;
 
     auto isFirstInstLabel = [](BB_LIST& bbList)
@@ -451,106 +487,370 @@ void BinaryEncodingIGA::DoAll()
                 continue;
             }
             ++IGAInstId;
-            Instruction  *igaInst = nullptr;
-            auto igaOpcode = getIGAOp(inst->opcode(), inst);
-            // common fields: op, predicate, flag reg, exec size, exec mask offset, mask ctrl, conditional modifier
-            const OpSpec* opSpec = &(platformModel->lookupOpSpec(igaOpcode));
-
-            if (opSpec->op == Op::INVALID)
+            const OpSpec* opSpec = getIGAOpSpec(inst);
+            if (!opSpec)
             {
-                std::cerr << "INVALID opcode" << ISA_Inst_Table[inst->opcode()].str << std::endl;
-                ASSERT_USER(false, "INVALID OPCODE.");
                 continue;
             }
-            Predication pred;
-            RegRef flagReg = { 0, 0 };
-            ExecSize execSize = getIGAExecSize(inst->getExecSize());
-            ChannelOffset chOff = getIGAChannelOffset(inst->getMaskOffset());
-            MaskCtrl maskCtrl = getIGAMaskCtrl(inst->opcode() == G4_jmpi ? true : inst->isWriteEnableInst());
-            FlagModifier condModifier = FlagModifier::NONE;
-
-            if (opSpec->supportsPredication())
+            Instruction* igaInst = translateInstruction(inst, opSpec, nullptr, bbNew);
+            currBB->appendInstruction(igaInst);
+
+            if (bbNew)
             {
-                flagReg = getIGAFlagReg(inst);
-                pred = getIGAPredication(inst->getPredicate());
+                //Fall through block is created.
+                //So the new block needs to become current block
+                //so that jump offsets can be calculated correctly
+                IGAKernel->appendBlock(bbNew);
+                currBB = bbNew;
             }
-            if (opSpec->supportsFlagModifier())
+            // If, in future, we generate multiple binary inst
+            // for a single G4_INST, then it should be safe to
+            // make pair between the G4_INST and first encoded
+            // binary inst.
+            encodedInsts.push_back(std::make_pair(igaInst, inst));
+        }
+    }
+
+    //std::cout << "USING IGA ENCODER. " << std::endl;
+    //Will compact only if Compaction flag is present
+    startTimer(TIMER_IGA_ENCODER);
+    bool autoCompact = true;
+
+    if (kernel.getOption(vISA_Compaction) == false)
+    {
+        autoCompact = false;
+    }
+
+    KernelEncoder encoder(IGAKernel, autoCompact);
+    encoder.encode();
+
+    stopTimer(TIMER_IGA_ENCODER);
+    bitsLen = encoder.getBinarySize();
+    bits = encoder.getBinary();
+
+    // encodedPC is available after encoding
+    for (auto&& inst : encodedInsts)
+    {
+        inst.second->setGenOffset(inst.first->getPC());
+    }
+}
+
+// Encodes the G4 instructions as they are translated, without building the
+// IGA IR kernel: the first pass lays out and encodes the instructions, the
+// encoder's second pass patches the jump targets. Each non-branching
+// instruction is translated into the same scratch storage and dropped once
+// encoded; only branches, which are patched at the end, are kept.
+void BinaryEncodingIGA::encodeStreamed(void*& bits, uint32_t& bitsLen)
+{
+    size_t maxInsts = 0;
+    for (auto bb : kernel.fg.BBs)
+    {
+        for (auto inst : *bb)
+        {
+            if (!inst->isLabel())
             {
-                flagReg = getIGAFlagReg(inst);
-                condModifier = getIGAFlagModifier(inst);
+                ++maxInsts;
             }
+        }
+    }
 
-            if (opSpec->isBranching())
+    startTimer(TIMER_IGA_ENCODER);
+    StreamEncoder encoder(*platformModel, IGAKernel->getMemManager(), maxInsts,
+        kernel.getOption(vISA_Compaction));
+    std::aligned_storage<sizeof(Instruction), alignof(Instruction)>::type scratch;
+    iga::Block *bbNew = nullptr;
+    for (auto bb : kernel.fg.BBs)
+    {
+        for (auto inst : *bb)
+        {
+            if (inst->isLabel())
             {
-                BranchCntrl brnchCtrl = getIGABranchCntrl(inst->asCFInst()->isBackward());
-                igaInst = IGAKernel->createBranchInstruction(
-                    *opSpec,
-                    pred,
-                    flagReg,
-                    execSize,
-                    chOff,
-                    maskCtrl,
-                    brnchCtrl);
+                encoder.markBlock(lookupIGABlock(inst->getLabel(), *IGAKernel));
+                continue;
             }
-            else if (opSpec->isSendOrSendsFamily())
+            ++IGAInstId;
+            const OpSpec* opSpec = getIGAOpSpec(inst);
+            if (!opSpec)
             {
-                SendDescArg desc = getIGASendDescArg(inst);
-                SendDescArg exDesc = getIGASendExDescArg(inst);
-                igaInst =
-                    IGAKernel->createSendInstruction(
-                    *opSpec,
-                    pred,
-                    flagReg,
-                    execSize,
-                    chOff,
-                    maskCtrl,
-                    exDesc,
-                    desc);
-                if (inst->isEOT())
-                {
-                    igaInst->addInstOpt(InstOpt::EOT);
-                }
-
+                continue;
             }
-            else if (opSpec->op == Op::NOP)
+            bool isScratch = !opSpec->isBranching();
+            Instruction* igaInst = translateInstruction(inst, opSpec, isScratch ? &scratch : nullptr, bbNew);
+            encoder.encode(*igaInst);
+            inst->setGenOffset(igaInst->getPC());
+            if (bbNew)
             {
-                igaInst = IGAKernel->createNopInstruction();
+                encoder.markBlock(bbNew);
             }
-            else if (opSpec->op == Op::ILLEGAL)
+            if (isScratch)
             {
-                igaInst = IGAKernel->createIllegalInstruction();
+                igaInst->~Instruction();
             }
-            else
+        }
+    }
+    encoder.finish();
+    stopTimer(TIMER_IGA_ENCODER);
+
+    bitsLen = encoder.getBinarySize();
+    bits = encoder.getBinary();
+}
+
+// Encodes the kernel again through encodeStreamed and checks that it gives
+// the same binary and instruction offsets as the IGA IR path did.
+void BinaryEncodingIGA::checkStreamEncode(const void* bits, uint32_t bitsLen)
+{
+    std::vector<int64_t> offsets;
+    for (auto bb : kernel.fg.BBs)
+    {
+        for (auto inst : *bb)
+        {
+            offsets.push_back(inst->getGenOffset());
+        }
+    }
+
+    // the streamed encode creates its own jump target blocks
+    labelToBlockMap.clear();
+    int numInsts = IGAInstId;
+    IGAInstId = 0;
+    void* streamBits = nullptr;
+    uint32_t streamBitsLen = 0;
+    encodeStreamed(streamBits, streamBitsLen);
+    MUST_BE_TRUE(IGAInstId == numInsts, "stream encode: instruction count differs");
+
+    if (streamBitsLen != bitsLen)
+    {
+        std::cerr << "stream encode: binary size " << streamBitsLen << " differs from " << bitsLen << "\n";
+        MUST_BE_TRUE(false, "stream encode differs from IGA kernel encode");
+    }
+    else if (memcmp(streamBits, bits, bitsLen) != 0)
+    {
+        uint32_t diff = 0;
+        while (static_cast<const uint8_t*>(streamBits)[diff] == static_cast<const uint8_t*>(bits)[diff])
+        {
+            ++diff;
+        }
+        std::cerr << "stream encode: binary differs at byte " << diff << "\n";
+        MUST_BE_TRUE(false, "stream encode differs from IGA kernel encode");
+    }
+
+    size_t i = 0;
+    for (auto bb : kernel.fg.BBs)
+    {
+        for (auto inst : *bb)
+        {
+            MUST_BE_TRUE(inst->getGenOffset() == offsets[i], "stream encode: instruction offset differs");
+            inst->setGenOffset(offsets[i++]);
+        }
+    }
+}
+
+const OpSpec *BinaryEncodingIGA::getIGAOpSpec(G4_INST *inst) const
+{
+    // common fields: op, predicate, flag reg, exec size, exec mask offset, mask ctrl, conditional modifier
+    const OpSpec* opSpec = &(platformModel->lookupOpSpec(getIGAOp(inst->opcode(), inst)));
+    if (opSpec->op == Op::INVALID)
+    {
+        std::cerr << "INVALID opcode" << ISA_Inst_Table[inst->opcode()].str << std::endl;
+        ASSERT_USER(false, "INVALID OPCODE.");
+        return nullptr;
+    }
+    return opSpec;
+}
+
+Instruction *BinaryEncodingIGA::newIGAInstruction(
+    const OpSpec &opSpec, ExecSize execSize, ChannelOffset chOff, MaskCtrl maskCtrl, void *storage)
+{
+    if (storage)
+    {
+        return ::new (storage) Instruction(opSpec, execSize, chOff, maskCtrl);
+    }
+    return new (&IGAKernel->getMemManager()) Instruction(opSpec, execSize, chOff, maskCtrl);
+}
+
+// Creates the IGA instruction for inst in storage if given, else in the IGA
+// kernel. bbNew is set to the fall-through block a branch without a JIP
+// jumps to; it starts right after the instruction.
+Instruction *BinaryEncodingIGA::translateInstruction(
+    G4_INST *inst, const OpSpec *opSpec, void *storage, Block *&bbNew)
+{
+    Instruction  *igaInst = nullptr;
+    auto igaOpcode = opSpec->op;
+    bbNew = nullptr;
+    Predication pred;
+    RegRef flagReg = { 0, 0 };
+    ExecSize execSize = getIGAExecSize(inst->getExecSize());
+    ChannelOffset chOff = getIGAChannelOffset(inst->getMaskOffset());
+    MaskCtrl maskCtrl = getIGAMaskCtrl(inst->opcode() == G4_jmpi ? true : inst->isWriteEnableInst());
+    FlagModifier condModifier = FlagModifier::NONE;
+
+    if (opSpec->supportsPredication())
+    {
+        flagReg = getIGAFlagReg(inst);
+        pred = getIGAPredication(inst->getPredicate());
+    }
+    if (opSpec->supportsFlagModifier())
+    {
+        flagReg = getIGAFlagReg(inst);
+        condModifier = getIGAFlagModifier(inst);
+    }
+
+    if (opSpec->isBranching())
+    {
+        BranchCntrl brnchCtrl = getIGABranchCntrl(inst->asCFInst()->isBackward());
+        igaInst = newIGAInstruction(*opSpec, execSize, chOff, maskCtrl, storage);
+        igaInst->setBranchCtrl(brnchCtrl);
+        igaInst->setPredication(pred);
+        igaInst->setFlagReg(flagReg);
+    }
+    else if (opSpec->isSendOrSendsFamily())
+    {
+        SendDescArg desc = getIGASendDescArg(inst);
+        SendDescArg exDesc = getIGASendExDescArg(inst);
+        igaInst = newIGAInstruction(*opSpec, execSize, chOff, maskCtrl, storage);
+        igaInst->setPredication(pred);
+        igaInst->setFlagReg(flagReg);
+        igaInst->setMsgDesc(desc);
+        igaInst->setExtMsgDesc(exDesc);
+        if (inst->isEOT())
+        {
+            igaInst->addInstOpt(InstOpt::EOT);
+        }
+
+    }
+    else if (opSpec->op == Op::NOP || opSpec->op == Op::ILLEGAL)
+    {
+        igaInst = newIGAInstruction(*opSpec, ExecSize::SIMD1, ChannelOffset::M0, MaskCtrl::NORMAL, storage);
+        igaInst->setPredication(Predication());
+        igaInst->setFlagModifier(FlagModifier::NONE);
+        igaInst->setFlagReg(REGREF_ZERO_ZERO);
+    }
+    else
+    {
+        igaInst = newIGAInstruction(*opSpec, execSize, chOff, maskCtrl, storage);
+        igaInst->setPredication(pred);
+        igaInst->setFlagModifier(condModifier);
+        igaInst->setFlagReg(flagReg);
+    }
+
+    igaInst->setID(inst->getId());
+    if (opSpec->supportsDestination())
+    {
+        assert(inst->getDst() && "dst must not be null");
+        G4_DstRegRegion* dst = inst->getDst();
+        DstModifier dstModifier = getIGADstModifier(inst->getSaturate());
+        Region::Horz hstride = getIGAHorz(dst->getHorzStride());
+        Type type = getIGAType(dst->getType());
+
+        //work around for SKL bug
+        //not all bits are copied from immediate descriptor
+        if (inst->isSend()                  &&
+            getGenxPlatform() >= GENX_SKL   &&
+            getGenxPlatform() < GENX_CNL)
+        {
+            G4_SendMsgDescriptor* msgDesc = inst->getMsgDesc();
+            G4_Operand* descOpnd = inst->isSplitSend() ? inst->getSrc(2) : inst->getSrc(1);
+            if (!descOpnd->isImm() && msgDesc->is16BitReturn())
+            {
+                type = Type::HF;
+            }
+        }
+
+        if (igaInst->isMacro())
+        {
+            RegRef regRef = getIGARegRef(dst);
+					Region::Horz hstride = getIGAHorz(dst->getHorzStride());
+            igaInst->setMacroDestination(
+                dstModifier,
+                getIGARegName(dst),
+                regRef,
+                getIGAImplAcc(dst->getAccRegSel()),
+						hstride,
+                type);
+        }
+        else if (dst->getRegAccess() == Direct)
+        {
+
+            igaInst->setDirectDestination(
+                dstModifier,
+                getIGARegName(dst),
+                getIGARegRef(dst),
+                hstride,
+                type);
+        }
+        else
+        { // Operand::Kind::INDIRECT
+            RegRef regRef = { 0, 0};
+            bool valid;
+            regRef.subRegNum = (uint8_t) dst->ExIndSubRegNum(valid);
+            igaInst->setInidirectDestination(
+                dstModifier,
+                regRef,
+                dst->getAddrImm(),
+                hstride,
+                type);
+        }
+    } // end setting destinations
+
+    if (opSpec->isBranching()     &&
+        igaOpcode != iga::Op::JMPI  &&
+        igaOpcode != iga::Op::RET   &&
+        igaOpcode != iga::Op::CALL  &&
+        igaOpcode != iga::Op::BRC   &&
+        igaOpcode != iga::Op::BRD)
+    {
+        if (inst->asCFInst()->getJip())
+        {
+            // encode jip/uip for branch inst
+            // note that it does not apply to jmpi/call/ret/brc/brd, which may have register sources. Their label
+            // appears directly as source operand instead.
+            G4_Operand* uip = inst->asCFInst()->getUip();
+            G4_Operand* jip = inst->asCFInst()->getJip();
+            //iga will take care off
+            if (uip)
             {
-                igaInst =
-                    IGAKernel->createBasicInstruction(
-                    *opSpec,
-                    pred,
-                    flagReg,
-                    execSize,
-                    chOff,
-                    maskCtrl,
-                    condModifier);
+                igaInst->setLabelSource(SourceIndex::SRC1, lookupIGABlock(uip->asLabel(), *IGAKernel), iga::Type::UD);
             }
 
-            igaInst->setID(inst->getId());
-            if (opSpec->supportsDestination())
+            igaInst->setLabelSource(SourceIndex::SRC0, lookupIGABlock(jip->asLabel(), *IGAKernel), iga::Type::UD);
+        }
+        else
+        {
+            //Creating a fall through block
+            bbNew = IGAKernel->createBlock();
+            igaInst->setLabelSource(SourceIndex::SRC0, bbNew, iga::Type::UD);
+        }
+    }
+    else
+    {
+        // set source operands
+        int numSrcToEncode = inst->getNumSrc();
+        for (int i = 0; i < numSrcToEncode; i++)
+        {
+            SourceIndex opIx = (SourceIndex)((int)SourceIndex::SRC0 + i);
+            G4_Operand* src = inst->getSrc(i);
+
+            if (src->isSrcRegRegion())
             {
-                assert(inst->getDst() && "dst must not be null");
-                G4_DstRegRegion* dst = inst->getDst();
-                DstModifier dstModifier = getIGADstModifier(inst->getSaturate());
-                Region::Horz hstride = getIGAHorz(dst->getHorzStride());
-                Type type = getIGAType(dst->getType());
-
-                //work around for SKL bug
-                //not all bits are copied from immediate descriptor
-                if (inst->isSend()                  &&
+                G4_SrcRegRegion* srcRegion = src->asSrcRegRegion();
+                SrcModifier srcMod = getIGASrcModifier(srcRegion->getModifier());
+                Region region = getIGARegion(srcRegion, i);
+                Type type = Type::INVALID;
+
+                //let IGA take care of types for send/s instructions
+                if (!opSpec->isSendOrSendsFamily())
+                {
+                    type = getIGAType(src->getType());
+
+                }
+                else if (i == 0 &&
                     getGenxPlatform() >= GENX_SKL   &&
                     getGenxPlatform() < GENX_CNL)
                 {
+                    //work around for SKL bug
+                    //not all bits are copied from immediate descriptor
                     G4_SendMsgDescriptor* msgDesc = inst->getMsgDesc();
                     G4_Operand* descOpnd = inst->isSplitSend() ? inst->getSrc(2) : inst->getSrc(1);
-                    if (!descOpnd->isImm() && msgDesc->is16BitReturn())
+                    if (!descOpnd->isImm() && msgDesc->is16BitInput())
                     {
                         type = Type::HF;
                     }
@@ -558,217 +858,65 @@ void BinaryEncodingIGA::DoAll()
 
                 if (igaInst->isMacro())
                 {
-                    RegRef regRef = getIGARegRef(dst);
-					Region::Horz hstride = getIGAHorz(dst->getHorzStride());
-                    igaInst->setMacroDestination(
-                        dstModifier,
-                        getIGARegName(dst),
+                    RegRef regRef = getIGARegRef(srcRegion);
+                    igaInst->setMacroSource(
+                        opIx,
+                        srcMod,
+                        getIGARegName(srcRegion),
                         regRef,
-                        getIGAImplAcc(dst->getAccRegSel()),
-						hstride,
+                        getIGAImplAcc(srcRegion->getAccRegSel()),
+								region,
                         type);
                 }
-                else if (dst->getRegAccess() == Direct)
+                else if (srcRegion->getRegAccess() == Direct)
                 {
-
-                    igaInst->setDirectDestination(
-                        dstModifier,
-                        getIGARegName(dst),
-                        getIGARegRef(dst),
-                        hstride,
+                    igaInst->setDirectSource(
+                        opIx,
+                        srcMod,
+                        getIGARegName(srcRegion),
+                        getIGARegRef(srcRegion),
+                        region,
                         type);
                 }
                 else
-                { // Operand::Kind::INDIRECT
-                    RegRef regRef = { 0, 0};
+                {
+                    RegRef regRef = { 0, 0 };
                     bool valid;
-                    regRef.subRegNum = (uint8_t) dst->ExIndSubRegNum(valid);
-                    igaInst->setInidirectDestination(
-                        dstModifier,
+                    regRef.subRegNum = (uint8_t)srcRegion->ExIndSubRegNum(valid);
+                    igaInst->setInidirectSource(
+                        opIx,
+                        srcMod,
                         regRef,
-                        dst->getAddrImm(),
-                        hstride,
+                        srcRegion->getAddrImm(),
+                        region,
                         type);
                 }
-            } // end setting destinations
-
-            if (opSpec->isBranching()     &&
-                igaOpcode != iga::Op::JMPI  &&
-                igaOpcode != iga::Op::RET   &&
-                igaOpcode != iga::Op::CALL  &&
-                igaOpcode != iga::Op::BRC   &&
-                igaOpcode != iga::Op::BRD)
+            }
+            else if (src->isLabel())
             {
-                if (inst->asCFInst()->getJip())
-                {
-                    // encode jip/uip for branch inst
-                    // note that it does not apply to jmpi/call/ret/brc/brd, which may have register sources. Their label
-                    // appears directly as source operand instead.
-                    G4_Operand* uip = inst->asCFInst()->getUip();
-                    G4_Operand* jip = inst->asCFInst()->getJip();
-                    //iga will take care off
-                    if (uip)
-                    {
-                        igaInst->setLabelSource(SourceIndex::SRC1, lookupIGABlock(uip->asLabel(), *IGAKernel), iga::Type::UD);
-                    }
-
-                    igaInst->setLabelSource(SourceIndex::SRC0, lookupIGABlock(jip->asLabel(), *IGAKernel), iga::Type::UD);
-                }
-                else
-                {
-                    //Creating a fall through block
-                    bbNew = IGAKernel->createBlock();
-                    igaInst->setLabelSource(SourceIndex::SRC0, bbNew, iga::Type::UD);
-                    IGAKernel->appendBlock(bbNew);
-                }
+                igaInst->setLabelSource(opIx, lookupIGABlock(src->asLabel(), *IGAKernel), iga::Type::UD);
             }
-            else
+            else if (src->isImm())
             {
-                // set source operands
-                int numSrcToEncode = inst->getNumSrc();
-                for (int i = 0; i < numSrcToEncode; i++)
-                {
-                    SourceIndex opIx = (SourceIndex)((int)SourceIndex::SRC0 + i);
-                    G4_Operand* src = inst->getSrc(i);
-
-                    if (src->isSrcRegRegion())
-                    {
-                        G4_SrcRegRegion* srcRegion = src->asSrcRegRegion();
-                        SrcModifier srcMod = getIGASrcModifier(srcRegion->getModifier());
-                        Region region = getIGARegion(srcRegion, i);
-                        Type type = Type::INVALID;
-
-                        //let IGA take care of types for send/s instructions
-                        if (!opSpec->isSendOrSendsFamily())
-                        {
-                            type = getIGAType(src->getType());
-
-                        }
-                        else if (i == 0 &&
-                            getGenxPlatform() >= GENX_SKL   &&
-                            getGenxPlatform() < GENX_CNL)
-                        {
-                            //work around for SKL bug
-                            //not all bits are copied from immediate descriptor
-                            G4_SendMsgDescriptor* msgDesc = inst->getMsgDesc();
-                            G4_Operand* descOpnd = inst->isSplitSend() ? inst->getSrc(2) : inst->getSrc(1);
-                            if (!descOpnd->isImm() && msgDesc->is16BitInput())
-                            {
-                                type = Type::HF;
-                            }
-                        }
-
-                        if (igaInst->isMacro())
-                        {
-                            RegRef regRef = getIGARegRef(srcRegion);
-                            igaInst->setMacroSource(
-                                opIx,
-                                srcMod,
-                                getIGARegName(srcRegion),
-                                regRef,
-                                getIGAImplAcc(srcRegion->getAccRegSel()),
-								region,
-                                type);
-                        }
-                        else if (srcRegion->getRegAccess() == Direct)
-                        {
-                            igaInst->setDirectSource(
-                                opIx,
-                                srcMod,
-                                getIGARegName(srcRegion),
-                                getIGARegRef(srcRegion),
-                                region,
-                                type);
-                        }
-                        else
-                        {
-                            RegRef regRef = { 0, 0 };
-                            bool valid;
-                            regRef.subRegNum = (uint8_t)srcRegion->ExIndSubRegNum(valid);
-                            igaInst->setInidirectSource(
-                                opIx,
-                                srcMod,
-                                regRef,
-                                srcRegion->getAddrImm(),
-                                region,
-                                type);
-                        }
-                    }
-                    else if (src->isLabel())
-                    {
-                        igaInst->setLabelSource(opIx, lookupIGABlock(src->asLabel(), *IGAKernel), iga::Type::UD);
-                    }
-                    else if (src->isImm())
-                    {
-                        Type type = getIGAType(src->getType());
-                        ImmVal val;
-                        val = src->asImm()->getImm();
-                        val.kind = getIGAImmType(src->getType());
-                        igaInst->setImmediateSource(opIx, val, type);
-                    }
-                    else
-                    {
-                        IGA_ASSERT_FALSE("unexpected src kind");
-                    }
-                } // for
+                Type type = getIGAType(src->getType());
+                ImmVal val;
+                val = src->asImm()->getImm();
+                val.kind = getIGAImmType(src->getType());
+                igaInst->setImmediateSource(opIx, val, type);
             }
-            igaInst->addInstOpts(getIGAInstOptSet(inst));
-
-
-
-#if _DEBUG
-            igaInst->validate();
-#endif
-            currBB->appendInstruction(igaInst);
-
-            if (bbNew)
+            else
             {
-                //Fall through block is created.
-                //So the new block needs to become current block
-                //so that jump offsets can be calculated correctly
-                currBB = bbNew;
+                IGA_ASSERT_FALSE("unexpected src kind");
             }
-            // If, in future, we generate multiple binary inst
-            // for a single G4_INST, then it should be safe to
-            // make pair between the G4_INST and first encoded
-            // binary inst.
-            encodedInsts.push_back(std::make_pair(igaInst, inst));
-        }
-    }
-
-    kernel.setAsmCount(IGAInstId);
-
-
-    if (m_kernelBuffer)
-    {
-        m_kernelBufferSize = 0;
-        delete static_cast<uint8_t*>(m_kernelBuffer);
-        m_kernelBuffer = nullptr;
+        } // for
     }
+    igaInst->addInstOpts(getIGAInstOptSet(inst));
 
-    //std::cout << "USING IGA ENCODER. " << std::endl;
-    //Will compact only if Compaction flag is present
-    startTimer(TIMER_IGA_ENCODER);
-    bool autoCompact = true;
 
-    if (kernel.getOption(vISA_Compaction) == false)
-    {
-        autoCompact = false;
-    }
-
-    KernelEncoder encoder(IGAKernel, autoCompact);
-    encoder.encode();
-
-    stopTimer(TIMER_IGA_ENCODER);
-    m_kernelBufferSize = encoder.getBinarySize();
-    m_kernelBuffer = allocCodeBlock(m_kernelBufferSize);
-    memcpy_s(m_kernelBuffer, m_kernelBufferSize, encoder.getBinary(), m_kernelBufferSize);
-
-    // encodedPC is available after encoding
-    for (auto&& inst : encodedInsts)
-    {
-        inst.second->setGenOffset(inst.first->getPC());
-    }
+#if _DEBUG
+    igaInst->validate();
+#endif
+    return igaInst;
 }
 
 SendDescArg BinaryEncodingIGA::getIGASendDescArg(G4_INST* sendInst) const
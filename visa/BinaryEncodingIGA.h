@@ -63,6 +63,16 @@ private:
     BinaryEncodingIGA(const BinaryEncodingIGA& other);
     BinaryEncodingIGA& operator=(const BinaryEncodingIGA& other);
 
+    void encodeWithIGAKernel(void*& bits, uint32_t& bitsLen);
+    void encodeStreamed(void*& bits, uint32_t& bitsLen);
+    void checkStreamEncode(const void* bits, uint32_t bitsLen);
+    const iga::OpSpec *getIGAOpSpec(G4_INST *inst) const;
+    iga::Instruction *newIGAInstruction(
+        const iga::OpSpec &opSpec, iga::ExecSize execSize, iga::ChannelOffset chOff,
+        iga::MaskCtrl maskCtrl, void *storage);
+    iga::Instruction *translateInstruction(
+        G4_INST *inst, const iga::OpSpec *opSpec, void *storage, iga::Block *&bbNew);
+
     iga::Instruction *encodeMathInstruction(G4_INST *inst);
     iga::Instruction *encodeBranchInstruction(G4_INST *inst);
     iga::Instruction *encodeTernaryInstruction(G4_INST *inst);
@@ -26,6 +26,11 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "BitSet.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BITSET_USE_SSE2
+#endif
+
 void BitSet::create( unsigned size )
 {
     const unsigned newArraySize = ( size + NUM_BITS_PER_ELT - 1 ) / NUM_BITS_PER_ELT;
@@ -34,8 +39,13 @@ void BitSet::create( unsigned size )
 
     if( size == 0 )
     {
-        free( m_BitSetArray );
+        if( m_Owned )
+        {
+            free( m_BitSetArray );
+        }
+        m_BitSetArray = NULL;
         m_Size = 0;
+        m_Owned = true;
         return;
     }
 
@@ -78,10 +88,14 @@ void BitSet::create( unsigned size )
                 memset( ptr, 0, newArraySize * sizeof(BITSET_ARRAY_TYPE) );
             }
 
-            free( m_BitSetArray );
+            if( m_Owned )
+            {
+                free( m_BitSetArray );
+            }
 
             m_BitSetArray = ptr;
             m_Size = size;
+            m_Owned = true;
         }
         else
         {
@@ -156,6 +170,82 @@ void vector_minus(T *__restrict__ p1, const T *const p2, unsigned n)
     }
 }
 
+// p1 |= p2, returns true if p1 changed
+template <typename T>
+bool vector_or_changed(T *__restrict__ p1, const T *const p2, unsigned n)
+{
+    unsigned i = 0;
+    T diff = 0;
+#ifdef BITSET_USE_SSE2
+    const unsigned eltsPerVec = sizeof(__m128i) / sizeof(T);
+    __m128i vdiff = _mm_setzero_si128();
+    for (; i + eltsPerVec <= n; i += eltsPerVec)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i*)(p1 + i));
+        __m128i r = _mm_or_si128(a, _mm_loadu_si128((const __m128i*)(p2 + i)));
+        vdiff = _mm_or_si128(vdiff, _mm_xor_si128(a, r));
+        _mm_storeu_si128((__m128i*)(p1 + i), r);
+    }
+    diff = _mm_movemask_epi8(_mm_cmpeq_epi8(vdiff, _mm_setzero_si128())) != 0xFFFF;
+#endif
+    for (; i < n; ++i)
+    {
+        T r = p1[i] | p2[i];
+        diff |= p1[i] ^ r;
+        p1[i] = r;
+    }
+    return diff != 0;
+}
+
+// dst = gen | (live & ~kill), returns true if dst changed
+template <typename T>
+bool vector_gen_kill(T *__restrict__ dst, const T *const gen, const T *const live, const T *const kill, unsigned n)
+{
+    unsigned i = 0;
+    T diff = 0;
+#ifdef BITSET_USE_SSE2
+    const unsigned eltsPerVec = sizeof(__m128i) / sizeof(T);
+    __m128i vdiff = _mm_setzero_si128();
+    for (; i + eltsPerVec <= n; i += eltsPerVec)
+    {
+        __m128i r = _mm_or_si128(_mm_loadu_si128((const __m128i*)(gen + i)),
+            _mm_andnot_si128(_mm_loadu_si128((const __m128i*)(kill + i)), _mm_loadu_si128((const __m128i*)(live + i))));
+        vdiff = _mm_or_si128(vdiff, _mm_xor_si128(_mm_loadu_si128((const __m128i*)(dst + i)), r));
+        _mm_storeu_si128((__m128i*)(dst + i), r);
+    }
+    diff = _mm_movemask_epi8(_mm_cmpeq_epi8(vdiff, _mm_setzero_si128())) != 0xFFFF;
+#endif
+    for (; i < n; ++i)
+    {
+        T r = gen[i] | (live[i] & ~kill[i]);
+        diff |= dst[i] ^ r;
+        dst[i] = r;
+    }
+    return diff != 0;
+}
+
+bool BitSet::unionWith( const BitSet& other )
+{
+    unsigned size = other.m_Size;
+
+    //grow the set to the size of the other set if necessary
+    if( m_Size < other.m_Size )
+    {
+        create( other.m_Size );
+        size = m_Size;
+    }
+
+    return vector_or_changed(m_BitSetArray, other.m_BitSetArray, getArraySize(size));
+}
+
+bool BitSet::assignGenKill( const BitSet& gen, const BitSet& live, const BitSet& kill )
+{
+    MUST_BE_TRUE(m_Size == gen.m_Size && m_Size == live.m_Size && m_Size == kill.m_Size,
+        "BitSet size mismatch");
+    return vector_gen_kill(m_BitSetArray, gen.m_BitSetArray, live.m_BitSetArray, kill.m_BitSetArray,
+        getArraySize(m_Size));
+}
+
 BitSet& BitSet::operator|=( const BitSet& other )
 {
     unsigned size = other.m_Size;
@@ -42,11 +42,12 @@ class BitSet
 #define NUM_BITS_PER_ELT ( sizeof(BITSET_ARRAY_TYPE) * BITS_PER_BYTE )
 
 public:
-    BitSet() : m_BitSetArray(nullptr), m_Size(0) {}
+    BitSet() : m_BitSetArray(nullptr), m_Size(0), m_Owned(true) {}
     BitSet(unsigned size, bool defaultValue)
     {
         m_BitSetArray = NULL;
         m_Size = 0;
+        m_Owned = true;
 
         create(size);
         if (defaultValue)
@@ -55,7 +56,16 @@ public:
         }
     }
 
-    BitSet(const BitSet &other) : m_BitSetArray(nullptr), m_Size(0)
+    // Use the caller provided storage of getArraySize(size) elements, e.g. a slab shared by
+    // many sets that lives as long as they do. The storage is not freed by the BitSet; if
+    // the set has to grow it switches to its own heap array.
+    BitSet(BITSET_ARRAY_TYPE* storage, unsigned size)
+        : m_BitSetArray(storage), m_Size(size), m_Owned(false)
+    {
+        clear();
+    }
+
+    BitSet(const BitSet &other) : m_BitSetArray(nullptr), m_Size(0), m_Owned(true)
     {
         copy(other);
     }
@@ -64,11 +74,21 @@ public:
     {
         m_BitSetArray = other.m_BitSetArray;
         m_Size = other.m_Size;
+        m_Owned = other.m_Owned;
         other.m_BitSetArray = nullptr;
         other.m_Size = 0;
+        other.m_Owned = true;
     }
 
-    ~BitSet() { std::free(m_BitSetArray); }
+    ~BitSet()
+    {
+        if (m_Owned)
+        {
+            std::free(m_BitSetArray);
+        }
+    }
+
+    static unsigned getArraySize(unsigned size) { return (size + NUM_BITS_PER_ELT - 1) / NUM_BITS_PER_ELT; }
 
     void resize(unsigned size) { create(size); }
     void clear()
@@ -325,10 +345,19 @@ public:
 
     BitSet& operator=(BitSet&& other)
     {
-        m_BitSetArray = other.m_BitSetArray;
-        m_Size = other.m_Size;
-        other.m_BitSetArray = nullptr;
-        other.m_Size = 0;
+        if (this != &other)
+        {
+            if (m_Owned)
+            {
+                std::free(m_BitSetArray);
+            }
+            m_BitSetArray = other.m_BitSetArray;
+            m_Size = other.m_Size;
+            m_Owned = other.m_Owned;
+            other.m_BitSetArray = nullptr;
+            other.m_Size = 0;
+            other.m_Owned = true;
+        }
 
         return *this;
     }
@@ -339,6 +368,7 @@ public:
         {
             std::swap(m_Size, other.m_Size);
             std::swap(m_BitSetArray, other.m_BitSetArray);
+            std::swap(m_Owned, other.m_Owned);
         }
     }
 
@@ -346,12 +376,19 @@ public:
     BitSet &operator&=(const BitSet &other);
     BitSet &operator-=(const BitSet &other);
 
+    // this |= other, returns true if any bit of this set changed
+    bool unionWith(const BitSet &other);
+    // this = gen + (live - kill), returns true if any bit of this set changed.
+    // All four sets must have the same size.
+    bool assignGenKill(const BitSet &gen, const BitSet &live, const BitSet &kill);
+
     void *operator new(size_t sz, vISA::
         Mem_Manager &m) { return m.alloc(sz); }
 
 protected:
     BITSET_ARRAY_TYPE* m_BitSetArray;
     unsigned m_Size;
+    bool m_Owned;
 
     void create(unsigned size);
     void copy(const BitSet &other)
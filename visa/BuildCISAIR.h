@@ -780,6 +780,11 @@ public:
 
     Options m_options;
 
+    // Make this builder, and the platform and stepping it was created for, the
+    // current ones of the calling thread. A thread must call this before it
+    // compiles for a builder created on another thread.
+    void enterThread() const;
+
     void setupNativeRelocs(unsigned int, const BasicRelocEntry*);
     NativeRelocs* getNativeRelocs(bool createIfNULL = true)
     {
@@ -814,12 +819,16 @@ private:
     // the current kernel being compiled.  It is updated in the ::compile() function
     VISAKernelImpl* m_currentKernel;
 
+    int compileFastPaths(const std::vector<VISAKernelImpl*>& units);
     void emitFCPatchFile();
 
     std::string testName;
 
     PVISA_WA_TABLE m_pWaTable;
 
+    // the platform and stepping once the options are parsed
+    PlatformState m_platformState;
+
     NativeRelocs* nativeRelocs;
 };
 extern _THREAD CISA_IR_Builder * pCisaBuilder;
@@ -29,6 +29,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <sstream>
 #include <fstream>
 #include <list>
+#include <atomic>
+#include <thread>
 
 #include "visa_igc_common_header.h"
 #include "Common_ISA.h"
@@ -339,9 +341,18 @@ int CISA_IR_Builder::CreateBuilder(
 		builder->InitVisaWaTable(platform, GetStepping());
 	}
 
+    // the options may have set the platform and stepping
+    builder->m_platformState = PlatformState();
+
     return CM_SUCCESS;
 }
 
+void CISA_IR_Builder::enterThread() const
+{
+    m_platformState.install();
+    pCisaBuilder = const_cast<CISA_IR_Builder*>(this);
+}
+
 int CISA_IR_Builder::DestroyBuilder(CISA_IR_Builder *builder)
 {
 
@@ -714,6 +725,100 @@ void Stitch_Compiled_Units( common_isa_header header, std::list<G4_Kernel*> comp
 }
 
 
+// Run compileFastPath on every unit (kernel or function) in order. A unit is
+// compiled with its own builder and memory, and only reads the options shared
+// with the other units, so with vISA_ParallelCompileThreads the units are
+// handed out to worker threads. The workers enter this builder first, as the
+// platform, stepping and current builder are per thread. Their timers are
+// added to the calling thread's, and stitching afterwards is unchanged.
+// Compilation stays serial when
+//  - a unit of a 3D compile has subroutine calls, as RA then turns off local RA
+//    in the shared options for the units compiled after it;
+//  - unique labels are emitted, since they are named after m_currentKernel;
+//  - kernel IDs are added, since they come from a file-static counter and must
+//    stay in unit order;
+//  - timers are not thread-local.
+int CISA_IR_Builder::compileFastPaths(const std::vector<VISAKernelImpl*>& units)
+{
+    unsigned numThreads = std::min(m_options.getuInt32Option(vISA_ParallelCompileThreads),
+        (uint32_t)units.size());
+#ifdef ANDROID
+    numThreads = 1;
+#endif
+    if (numThreads > 1 &&
+        (m_options.getOption(vISA_UniqueLabels) || m_options.getOption(vISA_AddKernelID)))
+    {
+        numThreads = 1;
+    }
+    for (size_t i = 0; numThreads > 1 && i < units.size(); i++)
+    {
+        for (auto inst : units[i]->getIRBuilder()->instList)
+        {
+            if (inst->isCall() && m_options.getTarget() == VISA_3D)
+            {
+                numThreads = 1;
+                break;
+            }
+        }
+    }
+
+    if (numThreads <= 1)
+    {
+        for (auto kernel : units)
+        {
+            m_currentKernel = kernel;
+            int status = kernel->compileFastPath();
+            if (status != CM_SUCCESS)
+            {
+                return status;
+            }
+        }
+        return CM_SUCCESS;
+    }
+
+    std::vector<int> status(units.size(), CM_SUCCESS);
+    std::vector<TimerTotals> workerTimers(numThreads - 1);
+    std::atomic<size_t> next(0);
+    auto compileUnits = [&]()
+    {
+        for (size_t idx = next++; idx < units.size(); idx = next++)
+        {
+            status[idx] = units[idx]->compileFastPath();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < numThreads - 1; ++t)
+    {
+        workers.push_back(std::thread([&, t]()
+        {
+            enterThread();
+            initTimer();
+            compileUnits();
+            getTimerTotals(workerTimers[t]);
+        }));
+    }
+    compileUnits();
+    for (auto& t : workers)
+    {
+        t.join();
+    }
+    for (auto& totals : workerTimers)
+    {
+        addTimerTotals(totals);
+    }
+
+    m_currentKernel = units.back();
+    for (int unitStatus : status)
+    {
+        if (unitStatus != CM_SUCCESS)
+        {
+            return unitStatus;
+        }
+    }
+    return CM_SUCCESS;
+}
+
 // default size of the kernel mem manager in bytes
 #define KERNEL_MEM_SIZE    (4*1024*1024)
 int CISA_IR_Builder::Compile( const char* nameInput)
@@ -803,6 +908,7 @@ int CISA_IR_Builder::Compile( const char* nameInput)
         std::list<G4_Kernel*> compilationUnits;
         std::list<VISAKernelImpl*> kernels;
         std::list<VISAKernelImpl*> functions;
+        std::vector<VISAKernelImpl*> units;
         for( iter = m_kernels.begin(), i = 0; iter != end; iter++, i++ )
         {
             VISAKernelImpl* kernel = (*iter);
@@ -832,15 +938,14 @@ int CISA_IR_Builder::Compile( const char* nameInput)
             {
                 kernels.push_back(kernel);
             }
+            units.push_back(kernel);
+        }
 
-            m_currentKernel = kernel;
-
-            int status =  kernel->compileFastPath();
-			if (status != CM_SUCCESS)
-			{
-                stopTimer(TIMER_TOTAL);
-				return status;
-            }
+        status = compileFastPaths(units);
+        if (status != CM_SUCCESS)
+        {
+            stopTimer(TIMER_TOTAL);
+            return status;
         }
 
         savedFCallStates savedFCallState;
@@ -43,6 +43,15 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "PreDefinedVars.h"
 
 
+#ifdef COLLECT_ALLOCATION_STATS
+#include <atomic>
+// shared by the builders of all the units, which may compile in parallel
+extern std::atomic<int> numRegionLookups;
+extern std::atomic<int> numRegionsCreated;
+extern std::atomic<int> numImmLookups;
+extern std::atomic<int> numImmsCreated;
+#endif
+
 #define MAX_DWORD_VALUE  0x7fffffff
 #define MIN_DWORD_VALUE  0x80000000
 #define MAX_UDWORD_VALUE 0xffffffff
@@ -192,7 +201,16 @@ class OperandHashTable
     {
         std::size_t operator()(const ImmKey& imm) const
         {
-            return (std::size_t) (imm.val ^ imm.valType);
+            // Mix the value and the type so that the many small constants of
+            // different types do not land in the same buckets
+            // (MurmurHash3 64-bit finalizer).
+            uint64_t h = (uint64_t)imm.val + (uint64_t)imm.valType * 0x9E3779B97F4A7C15ULL;
+            h ^= h >> 33;
+            h *= 0xFF51AFD7ED558CCDULL;
+            h ^= h >> 33;
+            h *= 0xC4CEB9FE1A85EC53ULL;
+            h ^= h >> 33;
+            return (std::size_t)h;
         }
     };
 
@@ -227,7 +245,8 @@ public:
 class RegionPool
 {
     Mem_Manager& mem;
-    std::vector<RegionDesc*> rgnlist;
+    // keyed by vstride, width and hstride packed into one integer
+    std::unordered_map<uint64_t, RegionDesc*> rgnTable;
 public:
     RegionPool(Mem_Manager& m) : mem(m) {}
     RegionDesc* createRegion(uint16_t vstride, uint16_t width, uint16_t hstride);
@@ -44,11 +44,22 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "PhyRegUsage.h"
 
 using namespace vISA;
+
+#ifdef COLLECT_ALLOCATION_STATS
+std::atomic<int> numRegionLookups(0);
+std::atomic<int> numRegionsCreated(0);
+std::atomic<int> numImmLookups(0);
+std::atomic<int> numImmsCreated(0);
+#endif
+
 //
 // look up an imm operand
 //
 G4_Imm* OperandHashTable::lookupImm(int64_t imm, G4_Type ty)
 {
+#ifdef COLLECT_ALLOCATION_STATS
+    numImmLookups++;
+#endif
     ImmKey key(imm, ty);
     auto iter = immTable.find(key);
     return iter != immTable.end() ? iter->second : nullptr;
@@ -68,6 +79,9 @@ G4_Label* OperandHashTable::lookupLabel(const char* lab)
 //
 G4_Imm* OperandHashTable::createImm(int64_t imm, G4_Type ty)
 {
+#ifdef COLLECT_ALLOCATION_STATS
+    numImmsCreated++;
+#endif
     G4_Imm* i = new (mem)G4_Imm(imm, ty);
     ImmKey key(imm, ty);
     immTable[key] = i;
@@ -95,23 +109,22 @@ G4_Label* OperandHashTable::createLabel(const char* lab)
 //
 RegionDesc* RegionPool::createRegion(uint16_t vstride, uint16_t width, uint16_t hstride)
 {
-
-    for (unsigned i = 0, size = (unsigned) rgnlist.size(); i < size; i++)
+#ifdef COLLECT_ALLOCATION_STATS
+    numRegionLookups++;
+#endif
+    uint64_t key = ((uint64_t)vstride << 32) | ((uint64_t)width << 16) | hstride;
+    RegionDesc*& region = rgnTable[key];
+    if (region == nullptr)
     {
-        RegionDesc* region = rgnlist[i];
-        if (region->vertStride == vstride &&
-            region->width == width &&
-            region->horzStride == hstride)
-        {
-            return region; // exist
-        }
+        //
+        // create one
+        //
+#ifdef COLLECT_ALLOCATION_STATS
+        numRegionsCreated++;
+#endif
+        region = new (mem) RegionDesc(vstride, width, hstride);
     }
-    //
-    // create one
-    //
-    RegionDesc* rd = new (mem) RegionDesc(vstride, width, hstride);
-    rgnlist.push_back(rd);
-    return rd;
+    return region;
 }
 
 
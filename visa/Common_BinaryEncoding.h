@@ -831,36 +831,71 @@ static struct _CompactSourceTable_
 
 namespace vISA
 {
-    class _BDWCompactControlTable_
+    // Maps the value of a compaction table entry back to its index. The
+    // tables have COMPACT_TABLE_SIZE entries, so they are kept in a flat
+    // open-addressed array at half load, probed linearly from a
+    // multiplicative hash of the key.
+    class _CompactIndexMap_
     {
-        const static unsigned maxEntry = 111;
-    Mem_Manager& mem;
+        const static unsigned numSlotsLog2 = 6;
+        const static unsigned numSlots = 1 << numSlotsLog2;
+        const static uint8_t emptySlot = 0xFF;
 
-        struct HashNode
-        {
-            uint32_t key;
-            uint8_t  idx;
-            HashNode* next;
+        uint32_t keys[numSlots];
+        uint8_t  idxs[numSlots];
 
-            HashNode(uint32_t k, uint8_t i, HashNode *nxt) : key(k), idx(i), next(nxt) {}
-        void *operator new(size_t sz, Mem_Manager& m) {return m.alloc(sz);}
-        };
+        static unsigned FindEntry(uint32_t key)
+        {
+            return (key * 0x9E3779B1u) >> (32 - numSlotsLog2);
+        }
 
-        HashNode* table[maxEntry];
+    public:
 
-        unsigned FindEntry(uint32_t key)
+        _CompactIndexMap_()
         {
-            return key % maxEntry;
-            // return (key & 0xF) | (key >> 9);
+            static_assert(2 * COMPACT_TABLE_SIZE <= numSlots, "compaction index map is too small");
+            memset(idxs, emptySlot, sizeof(idxs));
         }
 
-    public:
+        bool FindIndex(uint32_t &index, uint32_t key) const
+        {
+            for (unsigned i = FindEntry(key); idxs[i] != emptySlot; i = (i + 1) % numSlots)
+            {
+                if (keys[i] == key)
+                {
+                    index = idxs[i];
+                    return true;
+                }
+            }
+            return false;
+        }
 
-    _BDWCompactControlTable_ (Mem_Manager& m) : mem(m)
+        // A key that is already present is mapped to the new index if
+        // replace is set, and keeps its old index otherwise.
+        void AddIndex(uint32_t key, uint8_t idx, bool replace)
         {
-            for (unsigned i = 0; i < maxEntry; i++)
-                table[i] = NULL;
+            unsigned i = FindEntry(key);
+            for (; idxs[i] != emptySlot; i = (i + 1) % numSlots)
+            {
+                if (keys[i] == key)
+                {
+                    if (replace)
+                    {
+                        idxs[i] = idx;
+                    }
+                    return;
+                }
+            }
+            keys[i] = key;
+            idxs[i] = idx;
         }
+    };
+
+    class _BDWCompactControlTable_
+    {
+        _CompactIndexMap_ table;
+
+    public:
 
         bool FindIndex(uint32_t &index,
             uint32_t bits_033_032,
@@ -876,72 +911,29 @@ namespace vISA
                 (bits_023_012 << 4) |
                 (bits_031_031 << 16) |
                 (bits_033_032 << 17);
-            for (HashNode* n = table[FindEntry(i)]; n != NULL; n = n->next)
-            {
-                if (n->key == i)
-                {
-                    index = n->idx;
-                    return true;
-                }
-            }
-            return false;
+            return table.FindIndex(index, i);
         }
 
         void AddIndex(uint32_t key, uint8_t idx)
         {
-            int entry = FindEntry(key);
-            table[entry] = new (mem)HashNode(key, idx, table[entry]);
+            table.AddIndex(key, idx, true);
         }
     };
 
     class _BDWCompactSourceTable_
     {
-        const static unsigned maxEntry = 61;
-    Mem_Manager& mem;
-
-        struct HashNode
-        {
-            uint32_t key;
-            uint8_t  idx;
-            HashNode* next;
-
-            HashNode(uint32_t k, uint8_t i, HashNode *nxt) : key(k), idx(i), next(nxt) {}
-        void *operator new(size_t sz, Mem_Manager& m) {return m.alloc(sz);}
-        };
-
-        HashNode* table[maxEntry];
-
-        unsigned FindEntry(uint32_t key)
-        {
-            return key % maxEntry;
-            //return (key & 0x3) | ((key & 0x3f8) >> 1);
-        }
+        _CompactIndexMap_ table;
 
     public:
 
-    _BDWCompactSourceTable_ (Mem_Manager& m) : mem(m)
-        {
-            for (unsigned i = 0; i < maxEntry; i++)
-                table[i] = NULL;
-        }
-
         bool FindIndex(uint32_t &index, uint32_t bits)
         {
-            for (HashNode* n = table[FindEntry(bits)]; n != NULL; n = n->next)
-            {
-                if (n->key == bits)
-                {
-                    index = n->idx;
-                    return true;
-                }
-            }
-            return false;
+            return table.FindIndex(index, bits);
         }
 
         void AddIndex(uint32_t key, uint8_t idx)
         {
-            int entry = FindEntry(key);
-            table[entry] = new (mem)HashNode(key, idx, table[entry]);
+            table.AddIndex(key, idx, true);
         }
 
         uint32_t GetBits_120_109(uint32_t index)
@@ -957,52 +949,12 @@ namespace vISA
 
     class _BDWCompactSubRegTable_
     {
-        const static unsigned maxEntry = 37;
-        const static unsigned maxEntry1 = 37;
-        const static unsigned maxEntry2 = 37;
-
-    Mem_Manager& mem;
-
-        struct HashNode
-        {
-            uint32_t key;
-            uint8_t  idx;
-            HashNode* next;
-
-            HashNode(uint32_t k, uint8_t i, HashNode *nxt) : key(k), idx(i), next(nxt) {}
-        void *operator new(size_t sz, Mem_Manager& m) {return m.alloc(sz);}
-        };
-
-        HashNode* table[maxEntry];
-        HashNode* table1[maxEntry1];
-        HashNode* table2[maxEntry2];
-
-        unsigned FindEntry(uint32_t key)
-        {
-            return key % maxEntry;
-            //return (key >> 12) | ((key & 0xF) << 3) | (key & 0x380) ;
-        }
-
-        unsigned FindEntry1(uint32_t key)
-        {
-            return key % maxEntry1;
-        }
-
-        unsigned FindEntry2(uint32_t key)
-        {
-            return key % maxEntry2;
-        }
+        _CompactIndexMap_ table;
+        _CompactIndexMap_ table1;
+        _CompactIndexMap_ table2;
 
     public:
 
-    _BDWCompactSubRegTable_ (Mem_Manager& m) : mem(m)
-        {
-            for (unsigned i = 0; i < maxEntry; i++)
-            {
-                table[i] = table1[i] = table2[i] = NULL;
-            }
-        }
-
         bool FindIndex(uint32_t &index,
             uint32_t bits_100_096,
             uint32_t bits_068_064,
@@ -1011,29 +963,13 @@ namespace vISA
             uint32_t i = bits_052_048 |
                 (bits_068_064 << 5) |
                 (bits_100_096 << 10);
-            for (HashNode* n = table[FindEntry(i)]; n != NULL; n = n->next)
-            {
-                if (n->key == i)
-                {
-                    index = n->idx;
-                    return true;
-                }
-            }
-            return false;
+            return table.FindIndex(index, i);
         }
 
         bool FindIndex1(uint32_t &index,
             uint32_t bits_052_048)
         {
-            for (HashNode* n = table1[FindEntry1(bits_052_048)]; n != NULL; n = n->next)
-            {
-                if (n->key == bits_052_048)
-                {
-                    index = n->idx;
-                    return true;
-                }
-            }
-            return false;
+            return table1.FindIndex(index, bits_052_048);
         }
 
         bool FindIndex2(uint32_t &index,
@@ -1042,55 +978,23 @@ namespace vISA
         {
             uint32_t i = bits_052_048 |
                 (bits_068_064 << 5);
-            for (HashNode* n = table2[FindEntry2(i)]; n != NULL; n = n->next)
-            {
-                if (n->key == i)
-                {
-                    index = n->idx;
-                    return true;
-                }
-            }
-            return false;
+            return table2.FindIndex(index, i);
         }
 
         void AddIndex(uint32_t key, uint8_t idx)
         {
-            int entry = FindEntry(key);
-            table[entry] = new (mem)HashNode(key, idx, table[entry]);
+            table.AddIndex(key, idx, true);
         }
 
+        // the partial keys repeat, keep the first index for each
         void AddIndex1(uint32_t key, uint8_t idx)
         {
-            int entry = FindEntry1(key);
-            HashNode* n = table1[entry];
-            for (; n != NULL; n = n->next)
-            {
-                if (n->key == key)
-                {
-                    break;
-                }
-            }
-            if (n == NULL)
-            {
-                table1[entry] = new (mem)HashNode(key, idx, table1[entry]);
-            }
+            table1.AddIndex(key, idx, false);
         }
 
         void AddIndex2(uint32_t key, uint8_t idx)
         {
-            int entry = FindEntry2(key);
-            HashNode* n = table2[entry];
-            for (; n != NULL; n = n->next)
-            {
-                if (n->key == key)
-                {
-                    break;
-                }
-            }
-            if (n == NULL)
-            {
-                table2[entry] = new (mem)HashNode(key, idx, table2[entry]);
-            }
+            table2.AddIndex(key, idx, false);
         }
 
         uint32_t GetBits_100_096(uint32_t index)
@@ -1113,35 +1017,10 @@ namespace vISA
     // add Str in below struct to differentiate its loop up table
     class _BDWCompactDataTypeTableStr_
     {
-        const static unsigned maxEntry = 111;
-    Mem_Manager& mem;
-
-        struct HashNode
-        {
-            uint32_t key;
-            uint8_t  idx;
-            HashNode* next;
-
-            HashNode(uint32_t k, uint8_t i, HashNode *nxt) : key(k), idx(i), next(nxt) {}
-        void *operator new(size_t sz, Mem_Manager& m) {return m.alloc(sz);}
-        };
-
-        HashNode* table[maxEntry];
-
-        unsigned FindEntry(uint32_t key)
-        {
-            return key % maxEntry;
-            //return ((key & 0x3FC) >> 2) | ((key & 0x3000) >> 4);
-        }
+        _CompactIndexMap_ table;
 
     public:
 
-    _BDWCompactDataTypeTableStr_ (Mem_Manager& m) : mem(m)
-        {
-            for (unsigned i = 0; i < maxEntry; i++)
-                table[i] = NULL;
-        }
-
         bool FindIndex(uint32_t &index,
             uint32_t bits_063_061,
             uint32_t bits_094_089,
@@ -1151,21 +1030,12 @@ namespace vISA
             i = bits_046_035 |
                 (bits_094_089 << 12) |
                 (bits_063_061 << 18);
-            for (HashNode* n = table[FindEntry(i)]; n != NULL; n = n->next)
-            {
-                if (n->key == i)
-                {
-                    index = n->idx;
-                    return true;
-                }
-            }
-            return false;
+            return table.FindIndex(index, i);
         }
 
         void AddIndex(uint32_t key, uint8_t idx)
         {
-            int entry = FindEntry(key);
-            table[entry] = new (mem)HashNode(key, idx, table[entry]);
+            table.AddIndex(key, idx, true);
         }
 
     };
@@ -1433,11 +1303,7 @@ namespace vISA
         _CompactSourceTable3SrcCHV_ CompactSourceTable3SrcCHV;
 
     BinaryEncodingBase(Mem_Manager &m, G4_Kernel& k, std::string fname) 
-        : BDWCompactControlTable(m),
-        BDWCompactSourceTable(m),
-        BDWCompactSubRegTable(m),
-        BDWCompactDataTypeTableStr(m),
-        mem(m),
+        : mem(m),
         fileName(fname),
         kernel(k),
         instCounts(0)
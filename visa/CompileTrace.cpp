@@ -0,0 +1,270 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+#include "CompileTrace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+namespace
+{
+struct TraceSpan
+{
+    std::string name;
+    uint64_t begin;
+    uint64_t end;
+};
+
+// Spans of one thread. The mutex is only contended while a session is being
+// written out.
+struct ThreadTrace
+{
+    std::mutex lock;
+    std::vector<TraceSpan> spans;
+    unsigned tid = 0;
+    // set when the thread exits, the entry is dropped once its spans are drained
+    bool exited = false;
+};
+
+struct TraceRegistry
+{
+    std::mutex lock;
+    std::vector<std::shared_ptr<ThreadTrace>> threads;
+    unsigned nextTid = 1;
+    // start times of the sessions that are still open
+    std::multiset<uint64_t> sessions;
+};
+
+// number of EnableCompileTrace(true) calls not yet matched by a (false) one
+std::atomic<unsigned> traceEnableCount(0);
+
+TraceRegistry& getRegistry()
+{
+    static TraceRegistry registry;
+    return registry;
+}
+
+std::shared_ptr<ThreadTrace> newThreadTrace()
+{
+    auto trace = std::make_shared<ThreadTrace>();
+    TraceRegistry& registry = getRegistry();
+    std::lock_guard<std::mutex> guard(registry.lock);
+    trace->tid = registry.nextTid++;
+    registry.threads.push_back(trace);
+    return trace;
+}
+
+// Called when the thread that owns trace exits. Spans can only still be written
+// out by a session that is open now, so without one the entry goes right away.
+void releaseThreadTrace(const std::shared_ptr<ThreadTrace>& trace)
+{
+    TraceRegistry& registry = getRegistry();
+    std::lock_guard<std::mutex> guard(registry.lock);
+    std::lock_guard<std::mutex> threadGuard(trace->lock);
+    trace->exited = true;
+    if (registry.sessions.empty() || trace->spans.empty())
+    {
+        auto it = std::find(registry.threads.begin(), registry.threads.end(), trace);
+        if (it != registry.threads.end())
+        {
+            registry.threads.erase(it);
+        }
+    }
+}
+
+struct ThreadTraceOwner
+{
+    std::shared_ptr<ThreadTrace> trace = newThreadTrace();
+    ~ThreadTraceOwner()
+    {
+        releaseThreadTrace(trace);
+    }
+};
+
+ThreadTrace& getThreadTrace()
+{
+#ifdef ANDROID
+    // no thread-local storage, all threads share one buffer
+    static ThreadTraceOwner owner;
+#else
+    static thread_local ThreadTraceOwner owner;
+#endif
+    return *owner.trace;
+}
+
+void writeEscaped(std::ostream& os, const std::string& str)
+{
+    for (char c : str)
+    {
+        if (c == '"' || c == '\\')
+        {
+            os << '\\' << c;
+        }
+        else if ((unsigned char)c < 0x20)
+        {
+            char buf[8];
+            std::snprintf(buf, sizeof(buf), "\\u%04x", (unsigned)c);
+            os << buf;
+        }
+        else
+        {
+            os << c;
+        }
+    }
+}
+} // namespace
+
+void EnableCompileTrace(bool enable)
+{
+    if (enable)
+    {
+        traceEnableCount.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    unsigned count = traceEnableCount.load(std::memory_order_relaxed);
+    while (count != 0 &&
+        !traceEnableCount.compare_exchange_weak(count, count - 1, std::memory_order_relaxed))
+    {
+    }
+}
+
+bool IsCompileTraceEnabled()
+{
+    return traceEnableCount.load(std::memory_order_relaxed) != 0;
+}
+
+uint64_t GetCompileTraceTime()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void RecordCompileTraceSpan(const char* name, uint64_t beginNS, uint64_t endNS)
+{
+    if (!IsCompileTraceEnabled())
+    {
+        return;
+    }
+    ThreadTrace& trace = getThreadTrace();
+    std::lock_guard<std::mutex> guard(trace.lock);
+    trace.spans.push_back(TraceSpan{ name, beginNS, endNS });
+}
+
+uint64_t BeginCompileTraceSession()
+{
+    if (!IsCompileTraceEnabled())
+    {
+        return 0;
+    }
+    uint64_t start = GetCompileTraceTime();
+    TraceRegistry& registry = getRegistry();
+    std::lock_guard<std::mutex> guard(registry.lock);
+    registry.sessions.insert(start);
+    return start;
+}
+
+bool EndCompileTraceSession(uint64_t sessionStart, const char* fileName)
+{
+    if (sessionStart == 0)
+    {
+        return true;
+    }
+    uint64_t end = GetCompileTraceTime();
+
+    std::vector<std::pair<unsigned, TraceSpan>> spans;
+    TraceRegistry& registry = getRegistry();
+    {
+        std::lock_guard<std::mutex> guard(registry.lock);
+        auto it = registry.sessions.find(sessionStart);
+        if (it != registry.sessions.end())
+        {
+            registry.sessions.erase(it);
+        }
+        // spans that began before every open session are no longer needed
+        uint64_t keepFrom = registry.sessions.empty() ? end : *registry.sessions.begin();
+
+        for (auto it = registry.threads.begin(); it != registry.threads.end(); )
+        {
+            ThreadTrace& trace = **it;
+            std::unique_lock<std::mutex> threadGuard(trace.lock);
+            for (const TraceSpan& span : trace.spans)
+            {
+                if (span.begin >= sessionStart && span.end <= end)
+                {
+                    spans.emplace_back(trace.tid, span);
+                }
+            }
+            std::vector<TraceSpan> kept;
+            for (TraceSpan& span : trace.spans)
+            {
+                if (span.begin >= keepFrom)
+                {
+                    kept.push_back(std::move(span));
+                }
+            }
+            trace.spans.swap(kept);
+
+            if (trace.exited && trace.spans.empty())
+            {
+                threadGuard.unlock();
+                it = registry.threads.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    std::ofstream os(fileName, std::ios::out | std::ios::trunc);
+    if (!os)
+    {
+        return false;
+    }
+    // timestamps are in microseconds relative to the session start
+    os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    const char* sep = "\n";
+    for (const auto& entry : spans)
+    {
+        const TraceSpan& span = entry.second;
+        char times[64];
+        std::snprintf(times, sizeof(times), "\"ts\":%.3f,\"dur\":%.3f",
+            (span.begin - sessionStart) / 1000.0, (span.end - span.begin) / 1000.0);
+        os << sep << "{\"name\":\"";
+        writeEscaped(os, span.name);
+        os << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << entry.first << "," << times << "}";
+        sep = ",\n";
+    }
+    os << "\n]}\n";
+    return (bool)os;
+}
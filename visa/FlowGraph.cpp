@@ -4801,6 +4801,17 @@ void G4_BB::resetLocalId()
     }
 }
 
+void BBInstOrder::recompute()
+{
+    order.clear();
+    order.reserve(bb->size());
+    unsigned i = 0;
+    for (INST_LIST_ITER iter = bb->begin(), end = bb->end(); iter != end; ++iter, ++i)
+    {
+        order[*iter] = std::make_pair(i, iter);
+    }
+}
+
 void G4_BB::dump(bool printCFG = false) const
 {
     if (printCFG)
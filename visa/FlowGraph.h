@@ -491,6 +491,41 @@ public:
     // reset this BB's instruction's local id so they are [0,..#BBInst-1]
     void resetLocalId();
 };
+
+//
+// Numbers the instructions of a BB so that their relative order and their
+// position in the BB can be looked up in O(1), without touching local_id,
+// which passes use for their own numbering. Like resetLocalId(), it takes a
+// snapshot: call recompute() after inserting, removing or moving instructions
+// of the BB.
+//
+class BBInstOrder
+{
+    G4_BB* bb;
+    std::unordered_map<const G4_INST*, std::pair<unsigned, INST_LIST_ITER>> order;
+
+public:
+    explicit BBInstOrder(G4_BB* b) : bb(b) { recompute(); }
+
+    void recompute();
+
+    bool contains(const G4_INST* inst) const { return order.count(inst) != 0; }
+
+    // Return true if both instructions are in the BB and inst1 comes before inst2.
+    bool isBefore(const G4_INST* inst1, const G4_INST* inst2) const
+    {
+        auto it1 = order.find(inst1), it2 = order.find(inst2);
+        return it1 != order.end() && it2 != order.end() &&
+            it1->second.first < it2->second.first;
+    }
+
+    INST_LIST_ITER getIter(const G4_INST* inst) const
+    {
+        auto it = order.find(inst);
+        MUST_BE_TRUE(it != order.end(), "instruction is not in the BB");
+        return it->second.second;
+    }
+};
 }
 
 typedef enum
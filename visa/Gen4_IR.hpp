@@ -112,9 +112,13 @@ namespace vISA
             return t;
         }
 
-        void deallocate(void* p, size_type)
+        void deallocate(void* p, size_type n)
         {
-            //No deallocation for arena allocator.
+            // Small blocks such as list nodes are recycled by the arena; the
+            // rest is only freed with the arena. Allocators only compare equal
+            // when they share the Mem_Manager, so a list cannot splice in
+            // nodes that another manager would have to recycle.
+            mem_manager_ptr->free(p, n * sizeof(T));
         }
 
         pointer           address(reference x) const { return &x; }
@@ -133,9 +137,14 @@ namespace vISA
 
         size_type         max_size() const { return size_t(-1); }
 
-        bool operator==(const std_arena_based_allocator &) const { return true; }
+        template <class U>
+        bool operator==(const std_arena_based_allocator<U>& other) const
+        {
+            return mem_manager_ptr == other.mem_manager_ptr;
+        }
 
-        bool operator!=(const std_arena_based_allocator & a) const { return !operator==(a); }
+        template <class U>
+        bool operator!=(const std_arena_based_allocator<U>& other) const { return !operator==(other); }
     };
 }
 void resetRightBound(vISA::G4_Operand* opnd);
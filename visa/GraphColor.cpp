@@ -35,6 +35,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Timer.h"
 #include <fstream>
 #include <algorithm>
+#include <memory>
+#include <thread>
 #include "LocalRA.h"
 #include "DebugInfo.h"
 #include "SpillCleanup.h"
@@ -107,6 +109,13 @@ Interference::Interference(LivenessAnalysis* l, LiveRange**& lr, unsigned n, uns
 {
 }
 
+Interference::Interference(const Interference& other, LiveRange**& lr) :
+    compatibleSparseIntf(other.compatibleSparseIntf), gra(other.gra), kernel(other.kernel), lrs(lr),
+    builder(other.builder), maxId(other.maxId), splitStartId(other.splitStartId), splitNum(other.splitNum),
+    matrix(nullptr), liveAnalysis(other.liveAnalysis), sparseIntf(other.sparseIntf)
+{
+}
+
 inline bool Interference::varSplitCheckBeforeIntf(unsigned v1, unsigned v2)
 {
     LiveRange * l1 = lrs[v1];
@@ -1483,13 +1492,13 @@ bool Interference::interfereBetween(unsigned v1, unsigned v2) const
 
     if (useDenseMatrix())
     {
+        assert(matrix != nullptr && "matrix is not initialized");
         unsigned col = v2 / BITS_DWORD;
         return (matrix[v1 * getRowSize() + col] & BitMask[v2 - col * BITS_DWORD]) ? true : false;
     }
     else
     {
-        auto&& set = sparseMatrix[v1];
-        return set.find(v2) != set.end();
+        return sparseMatrix[v1].contains(v2);
     }
 }
 
@@ -2467,12 +2476,11 @@ void Interference::generateSparseIntfGraph()
     {
         for (uint32_t v1 = 0; v1 < maxId; ++v1)
         {
-            auto&& intfSet = sparseMatrix[v1];
-            for (uint32_t v2 : intfSet)
+            sparseMatrix[v1].forEach([this, v1](uint32_t v2)
             {
                 sparseIntf[v1].push_back(v2);
                 sparseIntf[v2].push_back(v1);
-            }
+            });
         }
     }
 
@@ -2497,6 +2505,27 @@ void Interference::generateSparseIntfGraph()
         float avgNeighbor = ((float)numNeighbor) / sparseIntf.size();
         std::cout << "\t--avg # neighbors: " << std::setprecision(6) << avgNeighbor << "\n";
         std::cout << "\t--max # neighbors: " << maxNeighbor << " (" << lrs[maxIndex]->getDcl()->getName() << ")\n";
+
+        size_t matrixSize = 0;
+        uint32_t numBitRows = 0;
+        if (useDenseMatrix())
+        {
+            matrixSize = getRowSize() * maxId * sizeof(uint32_t);
+        }
+        else
+        {
+            for (auto&& row : sparseMatrix)
+            {
+                matrixSize += row.getMemSize();
+                numBitRows += row.usesBits() ? 1 : 0;
+            }
+        }
+        std::cout << "\t--intf matrix: " << (useDenseMatrix() ? "dense" : "sparse") << ", " << matrixSize / 1024 << " KB";
+        if (!useDenseMatrix())
+        {
+            std::cout << ", " << numBitRows << " of " << maxId << " rows as bit vectors";
+        }
+        std::cout << "\n";
     }
 
     stopTimer(TIMER_INTERFERENCE);
@@ -5001,6 +5030,30 @@ GraphColor::GraphColor(LivenessAnalysis& live, unsigned totalGRF, bool hybrid, b
     m_options = builder.getOptions();
 }
 
+// intf keeps a reference to lrs, which it only reads once the body has set it
+GraphColor::GraphColor(const GraphColor& other) :
+    gra(other.gra), totalGRFRegCount(other.totalGRFRegCount), numVar(other.numVar), numSplitStartID(other.numSplitStartID),
+    numSplitVar(other.numSplitVar), intf(other.intf, lrs), regPool(other.regPool), builder(other.builder), lrs(NULL),
+    isHybrid(other.isHybrid), requireCallerSaveRestoreCode(false), requireCalleeSaveRestoreCode(false),
+    requireA0CallerSaveRestoreCode(false), requireFlagCallerSaveRestoreCode(false), forceSpill(other.forceSpill),
+    mem(GRAPH_COLOR_MEM_SIZE), m_options(other.m_options), kernel(other.kernel), liveAnalysis(other.liveAnalysis),
+    isCopy(true)
+{
+    oddTotalDegree = 1;
+    evenTotalDegree = 1;
+    oddTotalRegNum = 1;
+    evenTotalRegNum = 1;
+    oddMaxRegNum = 1;
+    evenMaxRegNum = 1;
+    spAddrRegSig = (unsigned*)mem.alloc(getNumAddrRegisters() * sizeof(unsigned));
+    // the forbidden vectors are shared, coloring only reads them
+    lrs = (LiveRange**)mem.alloc(sizeof(LiveRange*)*numVar);
+    for (unsigned i = 0; i < numVar; i++)
+    {
+        lrs[i] = new (mem)LiveRange(*other.lrs[i]);
+    }
+}
+
 //
 // lrs[i] gives the live range whose id is i
 //
@@ -5134,7 +5187,7 @@ void GraphColor::computeDegreeForARF()
     }
 }
 
-void GraphColor::computeSpillCosts(bool useSplitLLRHeuristic)
+void GraphColor::computeSpillCosts(bool useSplitLLRHeuristic, SpillHeuristic spillHeuristic)
 {
     std::vector <LiveRange *> addressSensitiveVars;
     float maxNormalCost = 0.0f;
@@ -5202,7 +5255,16 @@ void GraphColor::computeSpillCosts(bool useSplitLLRHeuristic)
         {
             float spillCost;
             // NOTE: Add 1 to degree to avoid divide-by-0.
-            if (m_options->getTarget() == VISA_3D)
+            if (spillHeuristic == SPILL_HEURISTIC_REF_DEGREE)
+            {
+                spillCost = 1.0f*lrs[i]->getRefCount() / (lrs[i]->getDegree() + 1);
+            }
+            else if (spillHeuristic == SPILL_HEURISTIC_REF_AREA)
+            {
+                // prefer spilling the large live ranges that free up the most registers per reference
+                spillCost = 1.0f*lrs[i]->getRefCount() / ((lrs[i]->getDegree() + 1) * lrs[i]->getNumRegNeeded());
+            }
+            else if (m_options->getTarget() == VISA_3D)
             {
                 if (useSplitLLRHeuristic)
                 {
@@ -5531,7 +5593,7 @@ void PhyRegUsage::updateRegUsage(LiveRange* lr)
 
 bool GraphColor::assignColors(ColorHeuristic colorHeuristicGRF, bool doBankConflict, bool highInternalConflict)
 {
-    if (builder.getOption(vISA_RATrace))
+    if (builder.getOption(vISA_RATrace) && !isCopy)
     {
         std::cout << "\t--" << (colorHeuristicGRF == ROUND_ROBIN ? "round-robin" : "first-fit") <<
             (doBankConflict ? " BCR" : "") << " graph coloring\n";
@@ -5768,7 +5830,7 @@ bool GraphColor::assignColors(ColorHeuristic colorHeuristicGRF, bool doBankConfl
     }
 
     // record RA type
-    if (liveAnalysis.livenessClass(G4_GRF))
+    if (liveAnalysis.livenessClass(G4_GRF) && !isCopy)
     {
         if (colorHeuristicGRF == ROUND_ROBIN)
         {
@@ -6169,6 +6231,7 @@ bool GraphColor::regAlloc(bool doBankConflictReduction,
             // RA may succeed even when RP is > total #GRF. We should investigate these cases and fix RPE
             assignColors(FIRST_FIT, false, false);
             //assert(requireSpillCode() && "inaccurate GRF pressure estimate");
+            recolorWithAlternativeSpillHeuristics(useSplitLLRHeuristic);
             stopTimer(TIMER_COLORING);
             return !requireSpillCode();
         }
@@ -6202,6 +6265,8 @@ bool GraphColor::regAlloc(bool doBankConflictReduction,
                 assignColors(FIRST_FIT, false, false);
             }
         }
+
+        recolorWithAlternativeSpillHeuristics(useSplitLLRHeuristic);
     }
     else if (liveAnalysis.livenessClass(G4_FLAG))
     {
@@ -6228,6 +6293,171 @@ bool GraphColor::regAlloc(bool doBankConflictReduction,
     return (requireSpillCode() == false);
 }
 
+//
+// Color the interference graph again from scratch with the given spill cost function.
+//
+void GraphColor::colorWithSpillHeuristic(bool useSplitLLRHeuristic, SpillHeuristic spillHeuristic)
+{
+    resetTemporaryRegisterAssignments();
+    spilledLRs.clear();
+    requireCallerSaveRestoreCode = requireCalleeSaveRestoreCode = false;
+    requireA0CallerSaveRestoreCode = requireFlagCallerSaveRestoreCode = false;
+
+    // determineColorOrdering() consumes the degrees, so start over from the interference graph
+    oddTotalDegree = evenTotalDegree = 1;
+    oddTotalRegNum = evenTotalRegNum = 1;
+    oddMaxRegNum = evenMaxRegNum = 1;
+    computeDegreeForGRF();
+    computeSpillCosts(useSplitLLRHeuristic, spillHeuristic);
+    colorOrder.clear();
+    determineColorOrdering();
+    assignColors(FIRST_FIT, false, false);
+}
+
+//
+// The first-fit coloring only spills the live ranges that are at the bottom of the
+// color order, so the spill cost function decides what gets spilled. When the coloring
+// from regAlloc() spills, color the same interference graph again with the alternative
+// spill cost functions and keep the assignment with the fewest spill/fill references.
+//
+// Each alternative colors its own copy of the live ranges and the interference graph on
+// its own thread. The G4 IR, the liveness and the forbidden vectors are only read.
+//
+void GraphColor::recolorWithAlternativeSpillHeuristics(bool useSplitLLRHeuristic)
+{
+    if (!requireSpillCode() ||
+        !builder.getOption(vISA_MultiSpillHeuristicRA) ||
+        forceSpill ||
+        isHybrid ||
+        gra.isReRAPass())
+    {
+        return;
+    }
+
+    struct Coloring
+    {
+        std::vector<std::pair<G4_VarBase*, unsigned>> assignment;
+        // spill costs of the heuristic that produced the assignment
+        std::vector<float> spillCosts;
+        // live ranges of this GraphColor, not of the copy that was colored
+        LIVERANGE_LIST spilled;
+        unsigned spillFillCount = 0;
+        bool callerSave = false;
+        bool calleeSave = false;
+        bool a0CallerSave = false;
+        bool flagCallerSave = false;
+    };
+
+    auto saveColoring = [this](GraphColor& coloring, Coloring& c)
+    {
+        c.assignment.resize(numVar);
+        c.spillCosts.resize(numVar);
+        for (unsigned i = 0; i < numVar; i++)
+        {
+            c.assignment[i] = std::make_pair(coloring.lrs[i]->getPhyReg(), coloring.lrs[i]->getPhyRegOff());
+            c.spillCosts[i] = coloring.lrs[i]->getSpillCost();
+        }
+        c.spilled.clear();
+        c.spillFillCount = 0;
+        for (auto lr : coloring.spilledLRs)
+        {
+            c.spilled.push_back(lrs[lr->getVar()->getId()]);
+            c.spillFillCount += lr->getRefCount();
+        }
+        c.callerSave = coloring.requireCallerSaveRestoreCode;
+        c.calleeSave = coloring.requireCalleeSaveRestoreCode;
+        c.a0CallerSave = coloring.requireA0CallerSaveRestoreCode;
+        c.flagCallerSave = coloring.requireFlagCallerSaveRestoreCode;
+    };
+
+    std::vector<SpillHeuristic> heuristics;
+    const SpillHeuristic alternatives[] = { SPILL_HEURISTIC_REF_DEGREE, SPILL_HEURISTIC_REF_AREA };
+    for (auto heuristic : alternatives)
+    {
+        if (heuristic == SPILL_HEURISTIC_REF_DEGREE &&
+            m_options->getTarget() == VISA_3D && useSplitLLRHeuristic)
+        {
+            // same as the default cost function
+            continue;
+        }
+        heuristics.push_back(heuristic);
+    }
+
+    // the copies are made before any thread starts since they read this coloring
+    std::vector<std::unique_ptr<GraphColor>> colorings;
+    for (size_t i = 0; i < heuristics.size(); i++)
+    {
+        colorings.emplace_back(new GraphColor(*this));
+    }
+
+    // the platform and stepping are per thread, and coloring reads them
+    PlatformState platformState;
+    std::vector<Coloring> results(heuristics.size());
+    auto runHeuristic = [&](size_t i)
+    {
+        platformState.install();
+        colorings[i]->colorWithSpillHeuristic(useSplitLLRHeuristic, heuristics[i]);
+        saveColoring(*colorings[i], results[i]);
+    };
+
+    // the calling thread colors with the first heuristic
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < heuristics.size(); i++)
+    {
+        workers.push_back(std::thread(runHeuristic, i));
+    }
+    if (!heuristics.empty())
+    {
+        runHeuristic(0);
+    }
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    Coloring best;
+    saveColoring(*this, best);
+    SpillHeuristic bestHeuristic = SPILL_HEURISTIC_DEFAULT;
+    for (size_t i = 0; i < heuristics.size(); i++)
+    {
+        Coloring& current = results[i];
+        if (builder.getOption(vISA_RATrace))
+        {
+            std::cout << "\t--spill heuristic " << heuristics[i] << ": " << current.spilled.size() <<
+                " variables spilled, " << current.spillFillCount << " spill/fill references\n";
+        }
+        if (current.spillFillCount < best.spillFillCount ||
+            (current.spillFillCount == best.spillFillCount && current.spilled.size() < best.spilled.size()))
+        {
+            std::swap(best, current);
+            bestHeuristic = heuristics[i];
+        }
+    }
+
+    for (unsigned i = 0; i < numVar; i++)
+    {
+        if (best.assignment[i].first)
+        {
+            lrs[i]->setPhyReg(best.assignment[i].first, best.assignment[i].second);
+        }
+        else
+        {
+            lrs[i]->resetPhyReg();
+        }
+        lrs[i]->setSpillCost(best.spillCosts[i]);
+    }
+    spilledLRs = best.spilled;
+    requireCallerSaveRestoreCode = best.callerSave;
+    requireCalleeSaveRestoreCode = best.calleeSave;
+    requireA0CallerSaveRestoreCode = best.a0CallerSave;
+    requireFlagCallerSaveRestoreCode = best.flagCallerSave;
+
+    if (builder.getOption(vISA_RATrace))
+    {
+        std::cout << "\t--using spill heuristic " << bestHeuristic << "\n";
+    }
+}
+
 void GraphColor::confirmRegisterAssignments()
 {
     for (unsigned i = 0; i < numVar; i++)
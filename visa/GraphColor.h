@@ -32,7 +32,9 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "SpillManagerGMRF.h"
 #include <list>
 #include <unordered_set>
+#include <unordered_map>
 #include <limits>
+#include <algorithm>
 #include "RPE.h"
 
 #include "BitSet.h"
@@ -322,6 +324,129 @@ namespace vISA
         void augmentIntfGraph();
     };
 
+    // One row of the upper-half interference matrix of a kernel that is too large for the
+    // dense matrix. A row starts out as a sorted vector of neighbor ids and switches to a
+    // bit vector over the columns [firstWord * BITS_DWORD, maxId] once the id vector would
+    // take more space than the bits.
+    class SparseIntfRow
+    {
+        std::vector<uint32_t> data;     // sorted ids, or the bit vector words if isBits
+        uint32_t rowId = 0;
+        uint32_t firstWord = 0;
+        uint32_t numWords = 0;
+        bool isBits = false;
+
+        void convertToBits()
+        {
+            std::vector<uint32_t> bits(numWords, 0);
+            for (uint32_t v : data)
+            {
+                bits[v / BITS_DWORD - firstWord] |= BitMask[v % BITS_DWORD];
+            }
+            data.swap(bits);
+            isBits = true;
+        }
+
+    public:
+        void init(uint32_t id, uint32_t rowSize)
+        {
+            // only ids > rowId are stored in the row
+            rowId = id;
+            firstWord = (rowId + 1) / BITS_DWORD;
+            numWords = rowSize - firstWord;
+        }
+
+        void insert(uint32_t v)
+        {
+            if (isBits)
+            {
+                data[v / BITS_DWORD - firstWord] |= BitMask[v % BITS_DWORD];
+                return;
+            }
+            auto it = std::lower_bound(data.begin(), data.end(), v);
+            if (it != data.end() && *it == v)
+            {
+                return;
+            }
+            if (data.size() + 1 > numWords)
+            {
+                convertToBits();
+                data[v / BITS_DWORD - firstWord] |= BitMask[v % BITS_DWORD];
+                return;
+            }
+            data.insert(it, v);
+        }
+
+        void insertBlock(uint32_t col, uint32_t block)
+        {
+            if (isBits)
+            {
+                data[col - firstWord] |= block;
+                return;
+            }
+            for (int i = 0; i < BITS_DWORD; ++i)
+            {
+                if (block & BitMask[i])
+                {
+                    insert(col * BITS_DWORD + i);
+                }
+            }
+        }
+
+        bool contains(uint32_t v) const
+        {
+            // the bits start at firstWord, which may cover ids <= rowId, so
+            // reject those before indexing
+            if (v <= rowId || v / BITS_DWORD < firstWord)
+            {
+                return false;
+            }
+            if (isBits)
+            {
+                if (v / BITS_DWORD - firstWord >= numWords)
+                {
+                    return false;
+                }
+                return (data[v / BITS_DWORD - firstWord] & BitMask[v % BITS_DWORD]) != 0;
+            }
+            return std::binary_search(data.begin(), data.end(), v);
+        }
+
+        // calls f(v) for every id in the row in increasing order
+        template <typename F>
+        void forEach(F f) const
+        {
+            if (!isBits)
+            {
+                for (uint32_t v : data)
+                {
+                    f(v);
+                }
+                return;
+            }
+            for (uint32_t j = 0; j < numWords; ++j)
+            {
+                uint32_t blk = data[j];
+                for (int k = 0; blk != 0; ++k, blk >>= 1)
+                {
+                    if (blk & 1)
+                    {
+                        f((firstWord + j) * BITS_DWORD + k);
+                    }
+                }
+            }
+        }
+
+        void clear()
+        {
+            data.clear();
+            isBits = false;
+        }
+
+        bool usesBits() const { return isBits; }
+        size_t getMemSize() const { return sizeof(*this) + data.capacity() * sizeof(uint32_t); }
+    };
+
     class Interference
     {
         friend class Augmentation;
@@ -331,7 +456,7 @@ namespace vISA
         // compatible ranges will not be present in sparseIntf set.
         // We store G4_Declare* instead of id is because variables
         // allocated by LRA will not have a valid id.
-        std::map<G4_Declare*, std::vector<G4_Declare*>> compatibleSparseIntf;
+        std::unordered_map<G4_Declare*, std::vector<G4_Declare*>> compatibleSparseIntf;
 
     private:
         GlobalRA& gra;
@@ -350,7 +475,7 @@ namespace vISA
         // we don't directly update spraseIntf to ensure uniqueness
         // like dense matrix, interference is not symmetric (that is, if v1 and v2 interfere and v1 < v2,
         // we insert (v1, v2) but not (v2, v1)) for better cache behavior
-        std::vector<std::unordered_set<uint32_t> > sparseMatrix;
+        std::vector<SparseIntfRow> sparseMatrix;
         const uint32_t denseMatrixLimit = 32768;
 
         void updateLiveness(BitSet& live, uint32_t id, bool val)
@@ -363,6 +488,10 @@ namespace vISA
     public:
         Interference(LivenessAnalysis* l, LiveRange**& lr, unsigned n, unsigned ns, unsigned nm,
             GlobalRA& g);
+        // Copies only the adjacency lists (sparseIntf and compatibleSparseIntf) that
+        // coloring reads; the interference matrix is not copied, so interfereBetween()
+        // must not be called on the copy.
+        Interference(const Interference& other, LiveRange**& lr);
 
         ~Interference()
         {
@@ -397,6 +526,10 @@ namespace vISA
             else
             {
                 sparseMatrix.resize(maxId);
+                for (unsigned i = 0; i < maxId; i++)
+                {
+                    sparseMatrix[i].init(i, getRowSize());
+                }
             }
         }
 
@@ -448,7 +581,7 @@ namespace vISA
             }
             else
             {
-                sparseMatrix[v1].emplace(v2);
+                sparseMatrix[v1].insert(v2);
             }
         }
 
@@ -464,15 +597,7 @@ namespace vISA
             }
             else
             {
-                auto&& intfSet = sparseMatrix[v1];
-                for (int i = 0; i < BITS_DWORD; ++i)
-                {
-                    if (block & BitMask[i])
-                    {
-                        uint32_t v2 = col * BITS_DWORD + i;
-                        intfSet.emplace(v2);
-                    }
-                }
+                sparseMatrix[v1].insertBlock(col, block);
             }
         }
 
@@ -552,6 +677,9 @@ namespace vISA
         LIVERANGE_LIST unconstrainedWorklist;
         LIVERANGE_LIST constrainedWorklist;
         unsigned int numColor = 0;
+        // set on the copies colored by recolorWithAlternativeSpillHeuristics(), which
+        // run on worker threads and must not update the kernel
+        bool isCopy = false;
 
 #define GRAPH_COLOR_MEM_SIZE 16*1024
 
@@ -704,12 +832,18 @@ namespace vISA
 
         void computeDegreeForGRF();
         void computeDegreeForARF();
-        void computeSpillCosts(bool useSplitLLRHeuristic);
+        void computeSpillCosts(bool useSplitLLRHeuristic, SpillHeuristic spillHeuristic = SPILL_HEURISTIC_DEFAULT);
         void determineColorOrdering();
         void removeConstrained();
         void relaxNeighborDegreeGRF(LiveRange* lr);
         void relaxNeighborDegreeARF(LiveRange* lr);
         bool assignColors(ColorHeuristic heuristicGRF, bool doBankConflict, bool highInternalConflict);
+        void recolorWithAlternativeSpillHeuristics(bool useSplitLLRHeuristic);
+        void colorWithSpillHeuristic(bool useSplitLLRHeuristic, SpillHeuristic spillHeuristic);
+
+        // Copy the live ranges and the interference graph of "other" into an
+        // independent coloring state with its own allocator.
+        GraphColor(const GraphColor& other);
 
         void clearSpillAddrLocSignature()
         {
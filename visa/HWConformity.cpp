@@ -5036,8 +5036,8 @@ bool HWConformity::convertMAD2MAC( INST_LIST_ITER iter, std::vector<G4_INST*> &m
         if (!builder.isOpndAligned(curInst->getDst(), GENX_GRF_REG_SIZ) || 
             (curInst->getDst()->getExecTypeSize() / accTypeSize) > 4)
         {
-            // ToDo: store the iter in madInst?
-            auto instIter = std::find(bb->begin(), bb->end(), curInst);
+            // curInst is the last mad, which lastMadIter still points to
+            auto instIter = lastMadIter;
             auto newDst = insertMovAfter(instIter, curInst->getDst(), curInst->getDst()->getType(), bb, Sixteen_Word);
             curInst->setDest(newDst);
         }
@@ -0,0 +1,253 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+
+#include "KernelBench.h"
+#include "BuildIR.h"
+#include "visa_igc_common_header.h"
+#include "Common_ISA_framework.h"
+#include "VISAKernel.h"
+#include "BuildCISAIR.h"
+#include "GraphColor.h"
+#include "RegAlloc.h"
+#include "BinaryEncoding.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace vISA;
+
+// number of instructions benchCompaction() compacts per run
+const uint32_t COMPACTION_BENCH_STREAM_SIZE = 1 << 20;
+
+void vISA::benchLiveness(CISA_IR_Builder* builder, unsigned runs, KernelBenchResult& result)
+{
+    for (VISAKernelImpl* visaKernel : builder->getKernels())
+    {
+        if (visaKernel->getKernel() == nullptr)
+        {
+            continue;
+        }
+        G4_Kernel& kernel = *visaKernel->getKernel();
+        PointsToAnalysis pointsToAnalysis(kernel.Declares, kernel.fg.getNumBB());
+        pointsToAnalysis.doPointsToAnalysis(kernel.fg);
+        GlobalRA gra(kernel, kernel.fg.builder->phyregpool, pointsToAnalysis);
+
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned i = 0; i < runs; i++)
+        {
+            LivenessAnalysis liveAnalysis(gra, G4_GRF | G4_INPUT, true);
+            liveAnalysis.computeLiveness(false);
+        }
+        result.timeNS += (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        result.runs += runs;
+    }
+}
+
+// Fills a _CompactIndexMap_ and a std::map with the same keys and compares the
+// results of looking up probes in both.
+static bool checkCompactIndexMap(const std::vector<uint32_t>& keys, bool replace,
+    const std::vector<uint32_t>& probes)
+{
+    _CompactIndexMap_ indexMap;
+    std::map<uint32_t, uint32_t> refMap;
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        indexMap.AddIndex(keys[i], (uint8_t)i, replace);
+        if (replace)
+        {
+            refMap[keys[i]] = (uint32_t)i;
+        }
+        else
+        {
+            refMap.emplace(keys[i], (uint32_t)i);
+        }
+    }
+
+    for (uint32_t key : probes)
+    {
+        uint32_t index = 0;
+        bool found = indexMap.FindIndex(index, key);
+        auto it = refMap.find(key);
+        if (found != (it != refMap.end()) || (found && index != it->second))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Whether kernel was encoded by BinaryEncoding with compaction on, so that
+// the compacted instructions it left behind can check the benchmark's.
+static bool encodedWithCompaction(G4_Kernel& kernel)
+{
+    if (kernel.getOption(vISA_IGAEncoder) || !kernel.getOption(vISA_Compaction))
+    {
+        return false;
+    }
+    return !(getGenxPlatform() >= GENX_CNL && kernel.getOption(vISA_BXMLEncoder));
+}
+
+bool vISA::benchCompaction(CISA_IR_Builder* builder, unsigned runs, KernelBenchResult& result)
+{
+    std::mt19937 rng(0x5eed);
+
+    // Randomized key sets up to the table size. A narrow key range makes
+    // duplicate keys common, a wide one checks the probing across the hash.
+    for (unsigned i = 0; i < 10000; i++)
+    {
+        uint32_t range = (i % 2) ? 0xFFFFFFFF : 48;
+        std::vector<uint32_t> keys(1 + rng() % COMPACT_TABLE_SIZE);
+        for (auto& key : keys)
+        {
+            key = rng() % range;
+        }
+        std::vector<uint32_t> probes(keys);
+        for (unsigned j = 0; j < COMPACT_TABLE_SIZE; j++)
+        {
+            probes.push_back(rng() % range);
+        }
+        if (!checkCompactIndexMap(keys, true, probes) ||
+            !checkCompactIndexMap(keys, false, probes))
+        {
+            return false;
+        }
+    }
+
+    // Encode every instruction of the compiled kernels again, uncompacted, the
+    // way ProduceBinaryInstructions() hands them to the compaction.
+    struct SourceInst
+    {
+        G4_INST* inst;
+        BinInst* compiledBin;
+        BinInst bin;
+        bool check;
+    };
+    std::vector<SourceInst> source;
+    Mem_Manager mem(4096);
+    std::unique_ptr<BinaryEncoding> encoder;
+    BinaryEncoding::InitPlatform(getGenxPlatform());
+    for (VISAKernelImpl* visaKernel : builder->getKernels())
+    {
+        if (visaKernel->getKernel() == nullptr)
+        {
+            continue;
+        }
+        G4_Kernel& kernel = *visaKernel->getKernel();
+        if (!encoder)
+        {
+            encoder.reset(new BinaryEncoding(mem, kernel, kernel.getName()));
+            encoder->InitCompactionTables();
+        }
+        BinaryEncoding kernelEncoder(mem, kernel, kernel.getName());
+        bool check = encodedWithCompaction(kernel);
+        for (G4_BB* bb : kernel.fg.BBs)
+        {
+            for (G4_INST* inst : *bb)
+            {
+                if (inst->opcode() == G4_label || inst->opcode() == G4_nop)
+                {
+                    continue;
+                }
+                BinInst* compiledBin = inst->getBinInst();
+                kernelEncoder.EncodeInstruction(inst);
+                inst->getBinInst()->SetMustCompactFlag(false);
+                // branch offsets are patched into the compiled ones after compaction
+                bool isBranch = inst->opcode() >= G4_jmpi && inst->opcode() <= G4_join;
+                source.push_back({ inst, compiledBin, *inst->getBinInst(), check && compiledBin && !isBranch });
+                inst->setBinInst(compiledBin);
+            }
+        }
+    }
+    if (source.empty())
+    {
+        return true;
+    }
+
+    // The compacted instructions must be the ones the compile produced.
+    bool matches = true;
+    for (auto& s : source)
+    {
+        if (s.check)
+        {
+            BinInst bin = s.bin;
+            s.inst->setBinInst(&bin);
+            bool compacted = encoder->compactOneInstruction(s.inst);
+            if (compacted != s.inst->isCompactedInst() ||
+                std::memcmp(bin.DWords, s.compiledBin->DWords, sizeof(bin.DWords)) != 0)
+            {
+                matches = false;
+            }
+            s.inst->setBinInst(s.compiledBin);
+        }
+    }
+
+    // The stream cycles through the instructions of all kernels. Since the
+    // compaction rewrites its input, every run compacts a fresh copy.
+    std::vector<G4_INST*> streamInsts(COMPACTION_BENCH_STREAM_SIZE);
+    std::vector<BinInst> streamBins(COMPACTION_BENCH_STREAM_SIZE);
+    for (size_t i = 0; i < COMPACTION_BENCH_STREAM_SIZE; i++)
+    {
+        streamInsts[i] = source[i % source.size()].inst;
+        streamBins[i] = source[i % source.size()].bin;
+    }
+
+    uint64_t numCompacted = 0;
+    std::vector<BinInst> bins;
+    for (unsigned run = 0; run < runs; run++)
+    {
+        bins = streamBins;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < COMPACTION_BENCH_STREAM_SIZE; i++)
+        {
+            G4_INST* inst = streamInsts[i];
+            inst->setBinInst(&bins[i]);
+            if (encoder->compactOneInstruction(inst))
+            {
+                numCompacted++;
+            }
+        }
+        result.timeNS += (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        result.runs += COMPACTION_BENCH_STREAM_SIZE;
+    }
+
+    for (auto& s : source)
+    {
+        s.inst->setBinInst(s.compiledBin);
+    }
+
+    // keep the compaction from being optimized away
+    volatile uint64_t sink = numCompacted;
+    (void)sink;
+    return matches;
+}
@@ -0,0 +1,63 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+
+#ifndef KERNEL_BENCH_H
+#define KERNEL_BENCH_H
+
+#include <cstdint>
+
+//
+// Microbenchmarks run by the vISA standalone driver. They are not part of the
+// JIT library, and nothing in the compile path calls them.
+//
+
+class CISA_IR_Builder;
+
+namespace vISA
+{
+    struct KernelBenchResult
+    {
+        uint64_t runs = 0;
+        uint64_t timeNS = 0;
+    };
+
+    // Computes GRF liveness runs times from scratch on every kernel compiled by
+    // builder, in the mode the RA verifier uses after register allocation. Each
+    // run builds a new LivenessAnalysis, so the set allocation is timed too.
+    void benchLiveness(CISA_IR_Builder* builder, unsigned runs, KernelBenchResult& result);
+
+    // Encodes every instruction of the kernels compiled by builder again and
+    // compacts a stream of about 1M of them, cycling through the kernels, runs
+    // times with the per-instruction routine ProduceBinaryInstructions() uses;
+    // result counts the instructions. Before timing, the compaction index maps
+    // are checked against std::map on randomized key sets, and the compacted
+    // instructions against the ones the compile produced. Returns false if
+    // either disagrees.
+    bool benchCompaction(CISA_IR_Builder* builder, unsigned runs, KernelBenchResult& result);
+}
+
+#endif // KERNEL_BENCH_H
@@ -491,11 +491,20 @@ static unsigned getLatencyHidingThreshold(Options *m_options)
     return unsigned(LATENCY_PRESSURE_THRESHOLD * Ratio);
 }
 
+// The GRF pressure the pre-RA scheduler should bring every block under, or 0
+// to use the default heuristics. With a budget, reducing pressure takes
+// priority over hiding latency.
+static unsigned getGRFBudget(Options *m_options)
+{
+    return m_options->getuInt32Option(vISA_preRA_ScheduleGRFBudget);
+}
+
 preRA_Scheduler::preRA_Scheduler(G4_Kernel& k, Mem_Manager& m, RPE* rpe)
     : kernel(k)
     , mem(m)
     , rpe(rpe)
     , m_options(kernel.getOptions())
+    , KernelMaxPressure(0)
 {
 }
 
@@ -516,11 +525,14 @@ bool preRA_Scheduler::run()
     SchedConfig config(SchedCtrl);
     RegisterPressure rp(kernel, mem, rpe);
     bool Changed = false;
+    unsigned Budget = getGRFBudget(m_options);
+    KernelMaxPressure = 0;
 
     for (auto bb : kernel.fg.BBs) {
         if (bb->size() < SMALL_BLOCK_SIZE || bb->size() > LARGE_BLOCK_SIZE) {
             SCHED_DUMP(std::cerr << "Skip block with instructions "
                 << bb->size() << "\n");
+            KernelMaxPressure = std::max(KernelMaxPressure, rp.getPressure(bb));
             continue;
         }
 
@@ -530,13 +542,16 @@ bool preRA_Scheduler::run()
             if (!L || TargetBB.compare(L->asLabel()->getLabel()) != 0) {
                 SCHED_DUMP(std::cerr << "Skip non-target block, " 
                                      << L->asLabel()->getLabel() << "\n");
+                KernelMaxPressure = std::max(KernelMaxPressure, rp.getPressure(bb));
                 continue;
             }
         }
 
         unsigned MaxPressure = rp.getPressure(bb);
-        if (MaxPressure <= Threshold && !config.UseLatency) {
+        if (MaxPressure <= Threshold && !config.UseLatency &&
+            (Budget == 0 || MaxPressure <= Budget)) {
             SCHED_DUMP(std::cerr << "Skip block with rp " << MaxPressure << "\n");
+            KernelMaxPressure = std::max(KernelMaxPressure, MaxPressure);
             continue;
         }
 
@@ -545,6 +560,10 @@ bool preRA_Scheduler::run()
         BB_Scheduler S(kernel, ddd, rp, config);
 
         auto tryRPReduction = [=]() {
+            // Any block over the budget is scheduled for pressure.
+            if (Budget > 0 && MaxPressure > Budget)
+                return true;
+
             if (!config.UseSethiUllman)
                  return false;
 
@@ -573,6 +592,9 @@ bool preRA_Scheduler::run()
             if (MaxPressure >= getLatencyHidingThreshold(m_options))
                 return false;
 
+            if (Budget > 0 && MaxPressure >= Budget)
+                return false;
+
             // simple ROI check.
             unsigned NumOfHighLatencyInsts = 0;
             for (auto Inst : *bb) {
@@ -597,7 +619,17 @@ bool preRA_Scheduler::run()
                 Changed = true;
             }
         }
+
+        KernelMaxPressure = std::max(KernelMaxPressure, MaxPressure);
+    }
+
+    // Report the pressure reached, so that the caller can tell if a SIMD
+    // width is likely to fit.
+    if (FINALIZER_INFO* jitInfo = kernel.fg.builder->getJitInfo()) {
+        jitInfo->maxGRFPressure = KernelMaxPressure;
     }
+    SCHED_DUMP(std::cerr << "Kernel max pressure is " << KernelMaxPressure
+                         << ", budget " << Budget << "\n");
 
     return Changed;
 }
@@ -1467,7 +1499,8 @@ bool BB_Scheduler::commitIfBeneficial(unsigned& MaxRPE, bool IsTopDown)
     }
 
     // Note that list::swap does not work for some reason, but list::splice works.
-    INST_LIST TempInsts;
+    // The nodes are spliced, so the list must share the block's allocator.
+    INST_LIST TempInsts(CurInsts.get_allocator());
     TempInsts.splice(TempInsts.begin(), CurInsts, CurInsts.begin(), CurInsts.end());
     assert(CurInsts.empty());
 
@@ -1482,6 +1515,10 @@ bool BB_Scheduler::commitIfBeneficial(unsigned& MaxRPE, bool IsTopDown)
     rp.recompute(getBB());
     unsigned NewRPE = rp.getPressure(getBB());
     unsigned LatencyPressureThreshold = getLatencyHidingThreshold(kernel.getOptions());
+    unsigned Budget = getGRFBudget(kernel.getOptions());
+    if (Budget > 0) {
+        LatencyPressureThreshold = std::min(LatencyPressureThreshold, Budget);
+    }
     if (config.UseLatency && IsTopDown) {
         // For hiding latency.
         if (NewRPE <= LatencyPressureThreshold) {
@@ -1492,8 +1529,13 @@ bool BB_Scheduler::commitIfBeneficial(unsigned& MaxRPE, bool IsTopDown)
             SCHED_DUMP(std::cerr << "the pressure is increased to " << NewRPE << "\n");
         }
     } else {
-        // For reducing rpe.
-        if (NewRPE + PRESSURE_REDUCTION_MIN_BENEFIT <= MaxRPE) {
+        // For reducing rpe. Over the budget, any reduction is taken as it
+        // may be what avoids a spill.
+        if (Budget > 0 && MaxRPE > Budget && NewRPE < MaxRPE) {
+            SCHED_DUMP(std::cerr << "schedule committed to meet the budget.\n\n");
+            MaxRPE = NewRPE;
+            return true;
+        } else if (NewRPE + PRESSURE_REDUCTION_MIN_BENEFIT <= MaxRPE) {
             bool AbortOnSpill = kernel.getOptions()->getOption(vISA_AbortOnSpill);
             if (kernel.getSimdSize() == 32 && AbortOnSpill) {
                 // It turns out that simd32 kernels may be scheduled like slicing, which
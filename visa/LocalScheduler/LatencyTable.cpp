@@ -0,0 +1,211 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+#include "LatencyTable.h"
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <ctime>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
+using namespace vISA;
+
+//
+// Build the latency model described by SKL_latencies.def. Opcodes without an
+// entry take the values of ADD, math functions without one those of INVM.
+//
+static LatencyTable::LatencyModel buildGen9Model()
+{
+    LatencyTable::LatencyModel model;
+
+#undef DEF_INSTR_LATENCY
+#undef DEF_MATH_LATENCY
+#undef DEF_SEND_LATENCY
+#define DEF_INSTR_LATENCY(OP, LAT, DEL) model.inst[OP] = LatencyTable::Latency(LAT, DEL);
+#define DEF_MATH_LATENCY(OP, LAT, DEL) model.math[OP] = LatencyTable::Latency(LAT, DEL);
+#define DEF_SEND_LATENCY(OP, LAT, DEL) model.send[OP] = LatencyTable::Latency(LAT, DEL);
+#include "SKL_latencies.def"
+    model.mulIntegerExtraLatency = MUL_INTEGER_EXTRA_LATENCY;
+
+    bool defined[G4_NUM_OPCODE] = { false };
+    bool mathDefined[MATH_RSQRTM + 1] = { false };
+#undef DEF_INSTR_LATENCY
+#undef DEF_MATH_LATENCY
+#undef DEF_SEND_LATENCY
+#define DEF_INSTR_LATENCY(OP, LAT, DEL) defined[OP] = true;
+#define DEF_MATH_LATENCY(OP, LAT, DEL) mathDefined[OP] = true;
+#define DEF_SEND_LATENCY(...)
+#include "SKL_latencies.def"
+#undef DEF_INSTR_LATENCY
+#undef DEF_MATH_LATENCY
+#undef DEF_SEND_LATENCY
+
+    for (int op = 0; op < G4_NUM_OPCODE; ++op)
+    {
+        if (!defined[op])
+        {
+            model.inst[op] = model.inst[G4_add];
+        }
+    }
+    for (int op = 0; op <= MATH_RSQRTM; ++op)
+    {
+        if (!mathDefined[op])
+        {
+            model.math[op] = model.math[MATH_INVM];
+        }
+    }
+    return model;
+}
+
+//
+// There are no separate measurements for Gen10 and Gen11, every platform uses
+// the Gen9 model.
+//
+const LatencyTable::LatencyModel &LatencyTable::getBuiltinModel()
+{
+    static const LatencyModel Gen9Model = buildGen9Model();
+    return Gen9Model;
+}
+
+//
+// Load a latency model from a file. Each line names an opcode, math function
+// or shared function the same way as the .def files, followed by its latency
+// and occupancy, e.g.
+//
+//     G4_add        12  2
+//     MATH_INV      18  4
+//     SFID_SAMPLER 298  2
+//
+// Text after '#' is a comment. Entries not in the file keep their values in
+// model. Returns false if the file can't be read or has a malformed line.
+//
+bool LatencyTable::loadModel(const char *fileName, LatencyModel &model)
+{
+    std::ifstream input(fileName);
+    if (!input)
+    {
+        std::cerr << "Failed to open latency model " << fileName << "\n";
+        return false;
+    }
+
+    std::unordered_map<std::string, Latency*> entries;
+#define HANDLE_INST(op, ...) entries["G4_" #op] = &model.inst[G4_ ## op];
+#define HANDLE_NAME_INST(op, ...) entries["G4_" #op] = &model.inst[G4_ ## op];
+#include "../G4Instruction.def"
+#define DEF_INSTR_LATENCY(...)
+#define DEF_MATH_LATENCY(OP, LAT, DEL) entries[#OP] = &model.math[OP];
+#define DEF_SEND_LATENCY(OP, LAT, DEL) entries[#OP] = &model.send[OP];
+#include "SKL_latencies.def"
+#undef DEF_INSTR_LATENCY
+#undef DEF_MATH_LATENCY
+#undef DEF_SEND_LATENCY
+    entries["MATH_RSQRTM"] = &model.math[MATH_RSQRTM];
+
+    std::string line;
+    for (unsigned lineNo = 1; std::getline(input, line); ++lineNo)
+    {
+        line = line.substr(0, line.find('#'));
+        std::istringstream fields(line);
+        std::string name;
+        if (!(fields >> name))
+        {
+            continue;
+        }
+
+        uint32_t latency = 0, occupancy = 0;
+        auto it = entries.find(name);
+        if (it == entries.end() || !(fields >> latency >> occupancy))
+        {
+            std::cerr << fileName << ":" << lineNo << ": bad latency entry\n";
+            return false;
+        }
+        *it->second = Latency(latency, occupancy);
+    }
+    return true;
+}
+
+//
+// Return the built-in model overridden by fileName, or null if the file can't
+// be loaded. A table is built for every kernel, so a parsed file is kept per
+// path, and only parsed again once its modification time or size changes.
+//
+std::shared_ptr<const LatencyTable::LatencyModel> LatencyTable::getFileModel(const char *fileName)
+{
+    struct CacheEntry
+    {
+        bool loaded = false;
+        time_t mtime = 0;
+        int64_t size = 0;
+        std::shared_ptr<const LatencyModel> model;
+    };
+    static std::mutex cacheMutex;
+    static std::map<std::string, CacheEntry> cache;
+
+    // A file that can't be stat'ed can't be loaded either, the failure is
+    // cached like any other until the file shows up.
+    time_t mtime = 0;
+    int64_t size = 0;
+    struct stat fileStat;
+    if (stat(fileName, &fileStat) == 0)
+    {
+        mtime = fileStat.st_mtime;
+        size = fileStat.st_size;
+    }
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    CacheEntry &entry = cache[fileName];
+    if (entry.loaded && entry.mtime == mtime && entry.size == size)
+    {
+        return entry.model;
+    }
+
+    std::shared_ptr<LatencyModel> model(new LatencyModel(getBuiltinModel()));
+    if (!loadModel(fileName, *model))
+    {
+        model.reset();
+    }
+    entry.loaded = true;
+    entry.mtime = mtime;
+    entry.size = size;
+    entry.model = model;
+    return model;
+}
+
+LatencyTable::LatencyTable(const Options *options)
+    : m_options(options), m_model(&getBuiltinModel())
+{
+    if (const char *fileName = m_options->getOptionCstr(vISA_LatencyModelFile))
+    {
+        m_overrideModel = getFileModel(fileName);
+        if (m_overrideModel)
+        {
+            m_model = m_overrideModel.get();
+        }
+    }
+}
@@ -2,6 +2,8 @@
 #define __LATENCY_TABLE_H
 
 #include "../BuildIR.h"
+#include <memory>
+
 namespace vISA
 {
     class LatencyTable {
@@ -27,37 +29,29 @@ namespace vISA
             uint32_t occupancy;
             uint32_t occupancyMultiplier;
         };
+
+        // The latency and occupancy of every opcode, math function and shared
+        // function, as flat arrays indexed by the enum value.
+        struct LatencyModel {
+            Latency inst[G4_NUM_OPCODE];
+            Latency math[MATH_RSQRTM + 1];
+            Latency send[SFID_NUM + 1];
+            // extra latency of an integer mul with dword sources
+            uint32_t mulIntegerExtraLatency;
+        };
+
     private:
         const Options *m_options;
-        std::map<G4_opcode, Latency> InstLatTable;
-        std::map<G4_MathOp, Latency> MathLatTable;
-        std::map<CISA_SHARED_FUNCTION_ID, Latency> SendLatTable;
-    public:
-        LatencyTable(const Options *options) : m_options(options) {
-#undef DEF_INSTR_LATENCY
-#undef DEF_MATH_LATENCY
-#undef DEF_SEND_LATENCY
-#define DEF_INSTR_LATENCY(OP, LAT, DEL) InstLatTable[OP] = {LAT, DEL};
-#define DEF_MATH_LATENCY(...)
-#define DEF_SEND_LATENCY(...)
-#include "SKL_latencies.def"
+        const LatencyModel *m_model;
+        // Set if the built-in model is overridden by vISA_LatencyModelFile.
+        std::shared_ptr<const LatencyModel> m_overrideModel;
 
-#undef DEF_INSTR_LATENCY
-#undef DEF_MATH_LATENCY
-#undef DEF_SEND_LATENCY
-#define DEF_INSTR_LATENCY(...)
-#define DEF_MATH_LATENCY(OP, LAT, DEL) MathLatTable[OP] = {LAT, DEL};
-#define DEF_SEND_LATENCY(...)
-#include "SKL_latencies.def"
+        static const LatencyModel &getBuiltinModel();
+        static bool loadModel(const char *fileName, LatencyModel &model);
+        static std::shared_ptr<const LatencyModel> getFileModel(const char *fileName);
 
-#undef DEF_INSTR_LATENCY
-#undef DEF_MATH_LATENCY
-#undef DEF_SEND_LATENCY
-#define DEF_INSTR_LATENCY(...)
-#define DEF_MATH_LATENCY(...)
-#define DEF_SEND_LATENCY(OP, LAT, DEL) SendLatTable[OP] = {LAT, DEL};
-#include "SKL_latencies.def"
-        }
+    public:
+        LatencyTable(const Options *options);
 
         Latency getLatency(G4_INST *inst) const {
             uint32_t latency = 0;
@@ -73,16 +67,16 @@ namespace vISA
             // 1. MATH
             if (inst->isMath()) {
                 G4_MathOp mop = inst->asMathInst()->getMathCtrl();
-                latency = MathLatTable.at(mop).latency;
-                occupancy = MathLatTable.at(mop).occupancy;
+                latency = m_model->math[mop].latency;
+                occupancy = m_model->math[mop].occupancy;
             }
             // 2. SEND
             else if (inst->isSend()) {
                 G4_SendMsgDescriptor *msgDesc = inst->getMsgDesc();
                 assert(msgDesc);
                 CISA_SHARED_FUNCTION_ID sfid = msgDesc->getFuncId();
-                latency = SendLatTable.at(sfid).latency;
-                occupancy = SendLatTable.at(sfid).occupancy;
+                latency = m_model->send[sfid].latency;
+                occupancy = m_model->send[sfid].occupancy;
                 // Force latency. FIXME: is this correct?
                 uint32_t forceLatency
                     = m_options->getuInt32Option(vISA_UnifiedSendCycle);
@@ -111,23 +105,16 @@ namespace vISA
                     if (IS_TYPE_INT(dstType)
                         && IS_DTYPE(src1Type)
                         && IS_DTYPE(src2Type)) {
-                        extraLatency = MUL_INTEGER_EXTRA_LATENCY;
+                        extraLatency = m_model->mulIntegerExtraLatency;
                     }
-                    assert(InstLatTable.count(opcode));
-                    latency = InstLatTable.at(opcode).latency + extraLatency;
-                    occupancy = InstLatTable.at(opcode).occupancy;
+                    latency = m_model->inst[opcode].latency + extraLatency;
+                    occupancy = m_model->inst[opcode].occupancy;
                     break;
                 }
                 default:
-                    auto it = InstLatTable.find(opcode);
-                    // If opcode not defined, use the values for ADD
-                    if (it == InstLatTable.end()) {
-                        latency = InstLatTable.at(G4_add).latency;
-                        occupancy = InstLatTable.at(G4_add).occupancy;
-                    } else {
-                        latency = it->second.latency;
-                        occupancy = it->second.occupancy;
-                    }
+                    // Opcodes not in the model have the values for ADD.
+                    latency = m_model->inst[opcode].latency;
+                    occupancy = m_model->inst[opcode].occupancy;
                     break;
                 }
             }
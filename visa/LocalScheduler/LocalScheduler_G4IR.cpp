@@ -31,8 +31,12 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Dependencies_G4IR.h"
 #include "../G4_Opcode.h"
 #include "../Timer.h"
+#include "CompileTrace.h"
 #include "visa_wa.h"
 #include <queue>
+#include <algorithm>
+#include <atomic>
+#include <thread>
 
 #define COISSUE_UNITS 2
 using namespace std;
@@ -207,9 +211,6 @@ void LocalScheduler::localScheduling()
 
     MUST_BE_TRUE(ib != bend, ERROR_SCHEDULER);
 
-    int buildDDD = 0, listSch = 0;
-    uint32_t totalCycle = 0;
-
     CM_BB_INFO* bbInfo = (CM_BB_INFO *)mem.alloc(fg.BBs.size() * sizeof(CM_BB_INFO));
     memset(bbInfo, 0, fg.BBs.size() * sizeof(CM_BB_INFO));
     int i = 0;
@@ -221,11 +222,16 @@ void LocalScheduler::localScheduling()
     const char *BBName = m_options->getOptionCstr(vISA_postRA_ScheduleBlock);
     string TargetBB(BBName == nullptr ? "" : BBName);
 
+    //
+    // Collect the blocks to schedule. Blocks that are too large for the scheduler
+    // window are broken up into sections that are scheduled on their own, and
+    // spliced back together once they are all scheduled.
+    //
+    std::vector<SchedWorkItem> items;
+    std::vector<std::pair<G4_BB*, std::vector<G4_BB*>>> splitBBs;
     for (; ib != bend; ++ib)
     {
         unsigned int instCountBefore = (uint32_t)(*ib)->size();
-        // mem pool for each BB
-        Mem_Manager bbMem(4096);
 
         if (instCountBefore < SCH_THRESHOLD)
         {
@@ -261,8 +267,7 @@ void LocalScheduler::localScheduling()
                     sections.push_back(tempBB);
                     tempBB->splice(tempBB->begin(),
                         (*ib), (*ib)->begin(), inst_it);
-                    G4_BB_Schedule schedule(fg.getKernel(), bbMem, tempBB, buildDDD, listSch,
-                        totalCycle, m_options, LT);
+                    items.push_back(SchedWorkItem(tempBB, -1));
 
                     count = 0;
                 }
@@ -274,28 +279,147 @@ void LocalScheduler::localScheduling()
                 }
             }
 
-            for (unsigned int i = 0; i < sections.size(); i++)
-            {
-                (*ib)->splice((*ib)->end(), sections[i], sections[i]->begin(), sections[i]->end());
-            }
+            splitBBs.push_back(std::make_pair(*ib, std::move(sections)));
         }
         else
         {
-            G4_BB_Schedule schedule(fg.getKernel(), bbMem, *ib, buildDDD, listSch, totalCycle,
-                m_options, LT);
-            bbInfo[i].id = (*ib)->getId();
-            bbInfo[i].staticCycle = schedule.sequentialCycle;
-            bbInfo[i].sendStallCycle = schedule.sendStallCycle;
-            bbInfo[i].loopNestLevel = (*ib)->getNestLevel();
+            items.push_back(SchedWorkItem(*ib, i));
         }
 
         i++;
     }
+
+    scheduleBlocks(items, m_options, LT);
+
+    for (auto& splitBB : splitBBs)
+    {
+        G4_BB* bb = splitBB.first;
+        for (G4_BB* section : splitBB.second)
+        {
+            bb->splice(bb->end(), section, section->begin(), section->end());
+        }
+    }
+
+    for (auto& item : items)
+    {
+        if (item.infoIdx >= 0)
+        {
+            bbInfo[item.infoIdx].id = item.bb->getId();
+            bbInfo[item.infoIdx].staticCycle = item.staticCycle;
+            bbInfo[item.infoIdx].sendStallCycle = item.sendStallCycle;
+            bbInfo[item.infoIdx].loopNestLevel = item.bb->getNestLevel();
+        }
+    }
+
     FINALIZER_INFO* jitInfo = fg.builder->getJitInfo();
     jitInfo->BBInfo = bbInfo;
     jitInfo->BBNum = i;
 }
 
+//
+// G4_Operand computes its bounds lazily on first use, and immediates are shared
+// between instructions, so the bounds have to be in place before the blocks are
+// handed out to worker threads.
+//
+void LocalScheduler::computeOperandBounds(std::vector<SchedWorkItem>& items)
+{
+    static const Gen4_Operand_Number opndNums[] =
+    {
+        Opnd_dst, Opnd_src0, Opnd_src1, Opnd_src2, Opnd_src3,
+        Opnd_pred, Opnd_condMod, Opnd_implAccSrc, Opnd_implAccDst
+    };
+
+    for (auto& item : items)
+    {
+        for (G4_INST* inst : *item.bb)
+        {
+            for (Gen4_Operand_Number opndNum : opndNums)
+            {
+                G4_Operand* opnd = inst->getOperand(opndNum);
+                if (opnd && !opnd->isImm() && !opnd->isLabel() && !opnd->isNullReg())
+                {
+                    opnd->getRightBound();
+                }
+            }
+        }
+    }
+}
+
+//
+// Schedule every block in items. With vISA_ParallelSchedulingThreads the blocks
+// are handed out to worker threads, each block with its own memory pool; the
+// result is the same as the serial order. Per-block times are recorded as
+// compile trace spans, the pass total stays under TIMER_SCHEDULING.
+//
+void LocalScheduler::scheduleBlocks(std::vector<SchedWorkItem>& items,
+    const Options* m_options, const LatencyTable& LT)
+{
+    int buildDDD = 0, listSch = 0;
+
+    auto scheduleItem = [&](SchedWorkItem& item)
+    {
+        CompileTraceScope traceScope(IsCompileTraceEnabled() ?
+            "Schedule BB" + std::to_string(item.bb->getId()) + ", " +
+            std::to_string(item.bb->size()) + " insts" : std::string());
+        // mem pool for each BB
+        Mem_Manager bbMem(4096);
+        uint32_t totalCycle = 0;
+        G4_BB_Schedule schedule(fg.getKernel(), bbMem, item.bb, buildDDD, listSch, totalCycle,
+            m_options, LT);
+        item.staticCycle = schedule.sequentialCycle;
+        item.sendStallCycle = schedule.sendStallCycle;
+    };
+
+    unsigned numThreads = std::min(m_options->getuInt32Option(vISA_ParallelSchedulingThreads),
+        (uint32_t)items.size());
+    if (numThreads <= 1)
+    {
+        for (auto& item : items)
+        {
+            scheduleItem(item);
+        }
+        return;
+    }
+
+    computeOperandBounds(items);
+
+    // hand out the largest blocks first to balance the workers
+    std::vector<SchedWorkItem*> order;
+    order.reserve(items.size());
+    for (auto& item : items)
+    {
+        order.push_back(&item);
+    }
+    std::stable_sort(order.begin(), order.end(),
+        [](SchedWorkItem* a, SchedWorkItem* b) { return a->bb->size() > b->bb->size(); });
+
+    std::atomic<size_t> next(0);
+    auto worker = [&]()
+    {
+        for (size_t idx = next++; idx < order.size(); idx = next++)
+        {
+            scheduleItem(*order[idx]);
+        }
+    };
+
+    // the platform and stepping are per thread, and the DDD reads them
+    PlatformState platformState;
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < numThreads; ++t)
+    {
+        workers.push_back(std::thread([&]()
+        {
+            platformState.install();
+            worker();
+        }));
+    }
+    worker();
+    for (auto& t : workers)
+    {
+        t.join();
+    }
+}
+
 void G4_BB_Schedule::setOptimumConsecutiveSends()
 {
     optimumConsecutiveSends = m_options->getuInt32Option(vISA_NumPackedSends);
@@ -254,7 +254,7 @@ class DDD {
     Mem_Manager &mem;
     Edge_Allocator depEdgeAllocator;
     int HWthreadsPerEU;
-    const LatencyTable LT;
+    const LatencyTable &LT;
 
     // Counter that holds num of sends scheduled by
     // list scheduler just before current instruction.
@@ -362,9 +362,20 @@ class LocalScheduler {
     FlowGraph &fg;
     Mem_Manager &mem;
 
+    // A block (or a section of a large block) to schedule, and its results.
+    struct SchedWorkItem {
+        G4_BB* bb;
+        int infoIdx;            // index into the jit BB info, -1 for a section
+        uint32_t staticCycle = 0;
+        uint32_t sendStallCycle = 0;
+        SchedWorkItem(G4_BB* b, int idx) : bb(b), infoIdx(idx) {}
+    };
+
     // send latencies are now defined in FFLatency in LIR.cpp
     void EmitNode(Node *);
     void isolateBarrierBBs();
+    static void computeOperandBounds(std::vector<SchedWorkItem>& items);
+    void scheduleBlocks(std::vector<SchedWorkItem>& items, const Options* m_options, const LatencyTable& LT);
 
 public:
     LocalScheduler(FlowGraph &flowgraph, Mem_Manager &m)
@@ -378,11 +389,15 @@ public:
     ~preRA_Scheduler();
     bool run();
 
+    // the highest block pressure the last run() left, in GRFs
+    unsigned getMaxPressure() const { return KernelMaxPressure; }
+
 private:
     G4_Kernel& kernel;
     Mem_Manager& mem;
     RPE* rpe;
     Options* m_options;
+    unsigned KernelMaxPressure;
 };
 
 } // namespace vISA
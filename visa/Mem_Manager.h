@@ -45,6 +45,13 @@ namespace vISA
             return _arenaManager.AllocDataSpace(size);
         }
 
+        // Give back a small block from alloc() so that a later alloc() of the
+        // same size can reuse it. The block must come from this manager.
+        void free(void* p, size_t size)
+        {
+            _arenaManager.FreeDataSpace(p, size);
+        }
+
     private:
 
         vISA::ArenaManager _arenaManager;
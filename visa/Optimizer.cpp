@@ -1124,6 +1124,11 @@ int Optimizer::optimization()
     // PreRA scheduling
     runPass(PI_preRA_Schedule);
 
+    if (RAFail)
+    {
+        return CM_SPILL;
+    }
+
     // perform register allocation
     runPass(PI_regAlloc);
 
@@ -9076,6 +9081,10 @@ public:
     // The basic block being examined.
     G4_BB *bb;
 
+    // The order of the instructions in bb. The transformation only changes
+    // operands and opcodes, so it stays valid for the whole block.
+    const BBInstOrder &instOrder;
+
     enum MadSeqKind { MK_unknown, MK_isSafe, MK_isNotSafe};
 
 private:
@@ -9089,14 +9098,17 @@ private:
     // The sequence of mad instruction to be examined.
     std::vector<G4_INST *> madSequence;
 
+    // The position of the last mad in bb.
+    INST_LIST_ITER lastMadIter;
+
     // The use chain of the last mad. This use chain ended with an instruction
     // that has *B/*W type, and the chain length is limited by a predefined
     // constant.
     std::vector<G4_INST *> lastMadUserChain;
 
 public:
-    MadSequenceInfo(IR_Builder &builder, G4_BB *bb)
-        : builder(builder), bb(bb), kind(MK_unknown), src2Def(nullptr) {}
+    MadSequenceInfo(IR_Builder &builder, G4_BB *bb, const BBInstOrder &instOrder)
+        : builder(builder), bb(bb), instOrder(instOrder), kind(MK_unknown), src2Def(nullptr) {}
 
     bool isSafe() const { return kind == MK_isSafe; }
     bool isNotSafe() const { return kind == MK_isNotSafe; }
@@ -9109,6 +9121,7 @@ public:
     void appendMad(INST_LIST_ITER begin, INST_LIST_ITER end)
     {
         madSequence.insert(madSequence.end(), begin, end);
+        lastMadIter = std::prev(end);
     }
     typedef std::vector<G4_INST *>::iterator mad_iter;
     mad_iter mad_begin() { return madSequence.begin(); }
@@ -9142,9 +9155,10 @@ private:
     // Check whether the user chain blocks this transformation or not.
     bool checkUserChain();
 
-    // Check if other instructions between defInst and useInst are also updating
-    // ACC registers, which may block this transformation.
-    bool checkACCDependency(G4_INST *defInst, G4_INST *useInst);
+    // Check if other instructions between defIter and useInst are also updating
+    // ACC registers, which may block this transformation. useInst must follow
+    // defIter in bb. On success, defIter is advanced to useInst.
+    bool checkACCDependency(INST_LIST_ITER &defIter, G4_INST *useInst);
 
     // The common type for accumulator operands.
     G4_Type getCommonACCType()
@@ -9408,15 +9422,18 @@ bool MadSequenceInfo::checkMadSequence()
     return true;
 }
 
-bool MadSequenceInfo::checkACCDependency(G4_INST *defInst, G4_INST *useInst)
+bool MadSequenceInfo::checkACCDependency(INST_LIST_ITER &defIter, G4_INST *useInst)
 {
-    auto iter = std::find(bb->begin(), bb->end(), defInst);
-    ASSERT_USER(iter != bb->end(), "no instruction found?");
+    if (!instOrder.isBefore(*defIter, useInst))
+        return false;
 
+    auto iter = defIter;
     for (++iter; (*iter) != useInst; ++iter) {
         if ((*iter)->defAcc() || (*iter)->useAcc() || (*iter)->mayExpandToAccMacro(builder))
             return false;
     }
+
+    defIter = iter;
     return true;
 }
 
@@ -9429,6 +9446,7 @@ bool MadSequenceInfo::checkUserChain()
 
     G4_INST *defInst = getLastMad();
     G4_INST *useInst = defInst->use_back().first;
+    INST_LIST_ITER defIter = lastMadIter;
 
     while (true)
     {
@@ -9468,7 +9486,7 @@ bool MadSequenceInfo::checkUserChain()
 
         // Now check between defInst and useInst, no ACC will be written by
         // other instructions.
-        if (!checkACCDependency(defInst, useInst))
+        if (!checkACCDependency(defIter, useInst))
             return false;
 
         if (isLastUser)
@@ -9536,7 +9554,10 @@ void MadSequenceInfo::populateSrc2Def()
     }
 
     // Check if there is any ACC dependency.
-    if (!checkACCDependency(src2Def, firstMad))
+    if (!instOrder.contains(src2Def))
+        return setNotSafe();
+    INST_LIST_ITER defIter = instOrder.getIter(src2Def);
+    if (!checkACCDependency(defIter, firstMad))
         return setNotSafe();
 
     // Check restrictions on compression to ensure that changing the destination
@@ -9799,7 +9820,8 @@ void Optimizer::lowerMadSequence()
             continue;
 
         // Object to gather information for ACC optimization.
-        MadSequenceInfo madInfo(builder, bb);
+        BBInstOrder instOrder(bb);
+        MadSequenceInfo madInfo(builder, bb, instOrder);
 
         auto iter = bb->begin();
         while (iter != bb->end())
@@ -181,6 +181,22 @@ class Optimizer
     {
         preRA_Scheduler Sched(kernel, mem, /*rpe*/ nullptr);
         Sched.run();
+
+        // With a GRF budget, a kernel that could not be scheduled to fit in
+        // the register file would spill, so when a spill aborts the compile,
+        // abort it now instead of after RA. The pressure is an RPE estimate,
+        // so it must exceed the register file by the abort margin (in
+        // percent); closer calls are left to RA.
+        const Options* opts = builder.getOptions();
+        unsigned abortPressure = kernel.getNumRegTotal() *
+            (100 + opts->getuInt32Option(vISA_preRA_ScheduleAbortMargin)) / 100;
+        if (opts->getuInt32Option(vISA_preRA_ScheduleGRFBudget) > 0 &&
+            opts->getOption(vISA_AbortOnSpill) &&
+            opts->getuInt32Option(vISA_AbortOnSpillThreshold) == 0 &&
+            Sched.getMaxPressure() > abortPressure)
+        {
+            RAFail = true;
+        }
     }
     void localSchedule()
     {
@@ -33,6 +33,11 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 enum ColorHeuristic {FIRST_FIT, ROUND_ROBIN};
 
+// Spill cost functions used to order live ranges for graph coloring.
+// DEFAULT is the per-target cost, the others are only used as alternatives
+// when the default coloring spills (see vISA_MultiSpillHeuristicRA).
+enum SpillHeuristic {SPILL_HEURISTIC_DEFAULT, SPILL_HEURISTIC_REF_DEGREE, SPILL_HEURISTIC_REF_AREA};
+
 // forward declares
 namespace vISA
 {
@@ -511,15 +511,22 @@ LivenessAnalysis::LivenessAnalysis(
     use_kill.resize(numBBId);
     indr_use.resize(numBBId);
 
+    //
+    // carve all the per-BB sets out of one slab instead of allocating each of them
+    //
+    const unsigned numBBSets = 7;
+    const unsigned setArraySize = BitSet::getArraySize(numVarId);
+    BITSET_ARRAY_TYPE* slab = (BITSET_ARRAY_TYPE*) m.alloc(
+        sizeof(BITSET_ARRAY_TYPE) * setArraySize * numBBSets * numBBId);
 	for (unsigned i = 0; i < numBBId; i++)
 	{
-		def_in[i]  = BitSet(numVarId, false);
-		def_out[i] = BitSet(numVarId, false);
-		use_in[i]  = BitSet(numVarId, false);
-		use_out[i] = BitSet(numVarId, false);
-		use_gen[i] = BitSet(numVarId, false);
-		use_kill[i]= BitSet(numVarId, false);
-		indr_use[i]= BitSet(numVarId, false);
+		def_in[i]  = BitSet(slab, numVarId); slab += setArraySize;
+		def_out[i] = BitSet(slab, numVarId); slab += setArraySize;
+		use_in[i]  = BitSet(slab, numVarId); slab += setArraySize;
+		use_out[i] = BitSet(slab, numVarId); slab += setArraySize;
+		use_gen[i] = BitSet(slab, numVarId); slab += setArraySize;
+		use_kill[i]= BitSet(slab, numVarId); slab += setArraySize;
+		indr_use[i]= BitSet(slab, numVarId); slab += setArraySize;
 	}
 
 	numFnId = (unsigned) fg.funcInfoTable.size();
@@ -746,6 +753,56 @@ void LivenessAnalysis::detectNeverDefinedVarRows()
 // uses of reg vars are anticipated, which tell use the uses of reg vars.Def and Use vectors encapsulate the liveness
 // of reg vars.
 //
+//
+// Order the BBs in reverse post-order of a DFS from the entry BB. BBs that are not
+// reachable from the entry are appended in layout order, each followed by its own
+// unvisited successors.
+//
+static void getReversePostOrder(FlowGraph& fg, std::vector<G4_BB*>& rpoBBs)
+{
+    std::vector<bool> visited(fg.BBs.size(), false);
+    std::vector<std::pair<G4_BB*, BB_LIST_ITER>> stack;
+    std::vector<G4_BB*> postOrder;
+    postOrder.reserve(fg.BBs.size());
+
+    auto dfs = [&](G4_BB* root)
+    {
+        visited[root->getId()] = true;
+        stack.push_back(std::make_pair(root, root->Succs.begin()));
+        while (!stack.empty())
+        {
+            G4_BB* bb = stack.back().first;
+            BB_LIST_ITER& succIt = stack.back().second;
+            if (succIt != bb->Succs.end())
+            {
+                G4_BB* succ = *succIt;
+                ++succIt;
+                if (!visited[succ->getId()])
+                {
+                    visited[succ->getId()] = true;
+                    stack.push_back(std::make_pair(succ, succ->Succs.begin()));
+                }
+            }
+            else
+            {
+                postOrder.push_back(bb);
+                stack.pop_back();
+            }
+        }
+    };
+
+    dfs(fg.getEntryBB());
+    for (auto bb : fg.BBs)
+    {
+        if (!visited[bb->getId()])
+        {
+            dfs(bb);
+        }
+    }
+
+    rpoBBs.assign(postOrder.rbegin(), postOrder.rend());
+}
+
 void LivenessAnalysis::computeLiveness(bool computePseudoKill)
 {
 	//
@@ -1270,6 +1327,16 @@ void LivenessAnalysis::computeLiveness(bool computePseudoKill)
 #endif
         }
 
+		//
+		// Both problems are solved with a worklist kept as a dirty flag per BB. Each sweep
+		// visits the dirty blocks in post-order (uses) or reverse post-order (defs), so most
+		// of the flow information is propagated in a single sweep, and only the neighbors of
+		// blocks whose sets changed are visited again.
+		//
+		std::vector<G4_BB*> rpoBBs;
+		getReversePostOrder(fg, rpoBBs);
+		std::vector<bool> dirty(numBBId, true);
+
 		//
 		// backward flow analysis to propagate uses (locate last uses)
 		//
@@ -1279,22 +1346,29 @@ void LivenessAnalysis::computeLiveness(bool computePseudoKill)
 		while (change)
 		{
 			change = false;
-			BB_LIST::iterator rit = fg.BBs.end();
-			do
+			for (auto rit = rpoBBs.rbegin(), rend = rpoBBs.rend(); rit != rend; ++rit)
 			{
+				G4_BB* bb = *rit;
+				if (!dirty[bb->getId()])
+				{
+					continue;
+				}
+				dirty[bb->getId()] = false;
+
 				//
 				// use_out = use_in(s1) + use_in(s2) + ...
 				// where s1 s2 ... are the successors of bb
 				// use_in  = use_gen + (use_out - use_kill)
 				//
-				--rit;
-				if (contextFreeUseAnalyze((*rit)))
+				if (contextFreeUseAnalyze(bb))
 				{
-					change = true;
+					for (auto pred : bb->Preds)
+					{
+						dirty[pred->getId()] = true;
+						change = true;
+					}
 				}
-
 			}
-			while (rit != fg.BBs.begin());
 		}
 
 		//
@@ -1305,20 +1379,30 @@ void LivenessAnalysis::computeLiveness(bool computePseudoKill)
 		// initialize entry block with payload input
 		//
 		def_in[fg.getEntryBB()->getId()] = inputDefs;
+		dirty.assign(numBBId, true);
 		change = true;
 		while (change)
 		{
 			change = false;
-			for (BB_LIST_ITER it = fg.BBs.begin(); it != fg.BBs.end(); it++)
+			for (auto bb : rpoBBs)
 			{
-				G4_BB* bb = (*it);
+				if (!dirty[bb->getId()])
+				{
+					continue;
+				}
+				dirty[bb->getId()] = false;
+
 				//
 				// def_in   = def_out(p1) + def_out(p2) + ... where p1 p2 ... are the predecessors of bb
 				// def_out |= def_in
 				//
 				if (contextFreeDefAnalyze(bb))
 				{
-					change = true;
+					for (auto succ : bb->Succs)
+					{
+						dirty[succ->getId()] = true;
+						change = true;
+					}
 				}
 			}
 		}
@@ -2896,68 +2980,38 @@ bool LivenessAnalysis::contextSensitiveForwardDataAnalyze(
 //
 // use_out = use_in(s1) + use_in(s2) + ... where s1 s2 ... are the successors of bb
 // use_in  = use_gen + (use_out - use_kill)
+// returns true if use_in changed
 //
 bool LivenessAnalysis::contextFreeUseAnalyze(G4_BB* bb)
 {
-	bool changed;
-
 	unsigned bbid = bb->getId();
 
-	if (bb->Succs.empty()) // exit block
+	for (BB_LIST_ITER it = bb->Succs.begin(); it != bb->Succs.end(); it++)
 	{
-		changed = false;
-	}
-
-	else
-	{
-		BitSet old = use_out[bbid];
-
-		for (BB_LIST_ITER it = bb->Succs.begin(); it != bb->Succs.end(); it++)
-		{
-			use_out[bbid] |= use_in[(*it)->getId()];
-		}
-
-		changed = (old != use_out[bbid]);
+		use_out[bbid].unionWith(use_in[(*it)->getId()]);
 	}
 
 	//
 	// in = gen + (out - kill)
 	//
-	use_in[bbid] = use_out[bbid];
-    use_in[bbid] -= use_kill[bbid];
-    use_in[bbid] |= use_gen[bbid];
-
-	return changed;
+	return use_in[bbid].assignGenKill(use_gen[bbid], use_out[bbid], use_kill[bbid]);
 }
 
 //
 // def_in = def_out(p1) + def_out(p2) + ... where p1 p2 ... are the predecessors of bb
 // def_out |= def_in
+// returns true if def_out changed
 //
 bool LivenessAnalysis::contextFreeDefAnalyze(G4_BB* bb)
 {
-	bool changed  = false;
 	unsigned bbid = bb->getId();
 
-	if (bb->Preds.empty())
-	{
-		changed = false;
-	}
-	else
+	for (BB_LIST_ITER it = bb->Preds.begin(); it != bb->Preds.end(); it++)
 	{
-		BitSet old = def_in[bbid];
-
-		for (BB_LIST_ITER it = bb->Preds.begin(); it != bb->Preds.end(); it++)
-		{
-			def_in[bbid] |= def_out[(*it)->getId()];
-		}
-
-		changed = (old != def_in[bbid]);
+		def_in[bbid].unionWith(def_out[(*it)->getId()]);
 	}
 
-	 def_out[bb->getId()] |= def_in[bb->getId()];
-
-	 return changed;
+	 return def_out[bbid].unionWith(def_in[bbid]);
 }
 
 void LivenessAnalysis::dump_bb_vector(char* vname, std::list<G4_BB*>& bbs, std::vector<BitSet>& vec)
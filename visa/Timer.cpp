@@ -26,6 +26,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "Option.h"
 #include "Timer.h"
+#include "CompileTrace.h"
 #include <iostream>
 #include <fstream>
 #include <string>
@@ -46,46 +47,23 @@ static const char* timerNames[TIMER_NUM_TIMERS] =
 #define CLOCK_TYPE CLOCK_MONOTONIC
 
 #if   !defined(_WIN32)
+    // The counter is read in nanoseconds; clock_getres is only a bound on the
+    // precision and does not need to be queried on every read.
     bool QueryPerformanceFrequency(LARGE_INTEGER *lpFrequency)
     {
-        struct timespec  Res;
-        INT              iRet;
-
-        if ( (iRet = clock_getres(CLOCK_TYPE, &Res)) != 0 )
-        {
-            return ERROR;
-        }
-
-        // resolution (precision) can't be in seconds for current machine and OS
-        if (Res.tv_sec != 0)
-        {
-            return ERROR;
-        }
-        lpFrequency->QuadPart = 1000000000LL / Res.tv_nsec;
-
+        lpFrequency->QuadPart = 1000000000LL;
         return SUCCEED;
     }
 
     bool QueryPerformanceCounter(LARGE_INTEGER *lpPerformanceCount)
     {
-        struct timespec     Res;
         struct timespec     t;
-        INT                 iRet;
 
-        if ( (iRet = clock_getres (CLOCK_TYPE, &Res)) != 0 )
+        if (clock_gettime(CLOCK_TYPE, &t) != 0)
         {
             return ERROR;
         }
-        if (Res.tv_sec != 0)
-        { // resolution (precision) can't be in seconds for current machine and OS
-            return ERROR;
-        }
-        if( (iRet = clock_gettime(CLOCK_TYPE, &t)) != 0)
-        {
-            return ERROR;
-        }
-        lpPerformanceCount->QuadPart = (1000000000LL * t.tv_sec +
-            t.tv_nsec) / Res.tv_nsec;
+        lpPerformanceCount->QuadPart = 1000000000LL * t.tv_sec + t.tv_nsec;
 
         return SUCCEED;
     }
@@ -104,6 +82,8 @@ struct Timer {
 };
 
 static _THREAD Timer timers[TIMER_NUM_TIMERS];
+// start of the trace span of each running timer, 0 if it is not being traced
+static _THREAD uint64_t traceStarts[TIMER_NUM_TIMERS];
 static _THREAD char kernelAsmName[256] = "";
 static _THREAD LARGE_INTEGER proc_freq;
 static _THREAD int numTimers = TIMER_NUM_TIMERS;
@@ -158,6 +138,10 @@ int createNewTimer(const char* name)
 
 void startTimer(int timer)
 {
+    if (timer < TIMER_NUM_TIMERS && IsCompileTraceEnabled())
+    {
+        traceStarts[timer] = GetCompileTraceTime();
+    }
 #ifdef MEASURE_COMPILATION_TIME
     if (timer < TIMER_NUM_TIMERS)
     {
@@ -188,6 +172,11 @@ void startTimer(int timer)
 
 void stopTimer(int timer)
 {
+    if (timer < TIMER_NUM_TIMERS && traceStarts[timer] != 0)
+    {
+        RecordCompileTraceSpan(timerNames[timer], traceStarts[timer], GetCompileTraceTime());
+        traceStarts[timer] = 0;
+    }
 #ifdef MEASURE_COMPILATION_TIME
     if (timer < TIMER_NUM_TIMERS)
     {
@@ -225,6 +214,61 @@ extern "C" int64_t getTimerTicks(unsigned int idx)
     return timers[idx].ticks;
 }
 
+void getTimerTotals(TimerTotals& totals)
+{
+    for (int i = 0; i < TIMER_NUM_TIMERS; i++)
+    {
+        totals.time[i] = timers[i].time;
+        totals.ticks[i] = timers[i].ticks;
+    }
+}
+
+void addTimerTotals(const TimerTotals& totals)
+{
+    for (int i = 0; i < TIMER_NUM_TIMERS; i++)
+    {
+        timers[i].time += totals.time[i];
+        timers[i].ticks += totals.ticks[i];
+    }
+}
+
+// Entry points for a client that runs the compile of a builder on another
+// thread than the one that created it. The creating thread hands its timers
+// over before the compile starts, the compiling thread takes them over and
+// hands them back once it is done, and the creating thread restores them
+// before reading any timer.
+extern "C" unsigned int getTimerStateSize()
+{
+    return sizeof(TimerTotals);
+}
+
+extern "C" void handOffTimers(void* state)
+{
+    // TIMER_TOTAL and TIMER_BUILDER run from builder creation into Compile()
+    stopTimer(TIMER_BUILDER);
+    stopTimer(TIMER_TOTAL);
+    getTimerTotals(*static_cast<TimerTotals*>(state));
+}
+
+extern "C" void takeOverTimers(const void* state)
+{
+    initTimer();
+    addTimerTotals(*static_cast<const TimerTotals*>(state));
+    startTimer(TIMER_TOTAL);
+    startTimer(TIMER_BUILDER);
+}
+
+extern "C" void handBackTimers(void* state)
+{
+    getTimerTotals(*static_cast<TimerTotals*>(state));
+}
+
+extern "C" void restoreTimers(const void* state)
+{
+    initTimer();
+    addTimerTotals(*static_cast<const TimerTotals*>(state));
+}
+
 double getTimerUS(unsigned int idx)
 {
     return (timers[idx].ticks * 1000000) / (double)proc_freq.QuadPart;
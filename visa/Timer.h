@@ -66,5 +66,15 @@ typedef enum TIMERS
 } TIMERS;
 #undef DEF_TIMER
 
+// Timers are per thread. A thread compiling on behalf of another one reads its
+// totals with getTimerTotals and the other thread adds them to its own timers.
+struct TimerTotals
+{
+    double time[TIMER_NUM_TIMERS];
+    LONGLONG ticks[TIMER_NUM_TIMERS];
+};
+void getTimerTotals(TimerTotals& totals);
+void addTimerTotals(const TimerTotals& totals);
+
 #endif
 
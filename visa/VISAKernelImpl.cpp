@@ -34,6 +34,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "JitterDataStruct.h"
 #include "VISAKernel.h"
 #include "Timer.h"
+#include "CompileTrace.h"
 #include "FlowGraph.h"
 #include "BuildIR.h"
 #include "Optimizer.h"
@@ -124,6 +125,7 @@ int VISAKernelImpl::calculateTotalInputSize()
 
 int VISAKernelImpl::compileFastPath()
 {
+    CompileTraceScope traceScope(IsCompileTraceEnabled() ? std::string("vISA unit ") + getName() : std::string());
     int status = CM_SUCCESS;
 
     if(getIsKernel())
@@ -193,6 +193,11 @@ Stepping GetStepping( void )
     return stepping;
 }
 
+void SetVisaStepping( Stepping vStepping )
+{
+    stepping = vStepping;
+}
+
 const char * GetSteppingString(void)
 {
     static const char* steppingName[Step_none + 1] =
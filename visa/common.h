@@ -191,6 +191,22 @@ extern "C" void InitStepping();
 extern "C" int SetStepping( const char* s);
 extern "C" Stepping GetStepping( void );
 extern "C" const char * GetSteppingString( void );
+extern "C" void SetVisaStepping( Stepping vStepping );
+
+// The platform and stepping are per thread. A thread that compiles on behalf of
+// another captures that thread's PlatformState before it starts and installs
+// it before doing anything that depends on the platform.
+struct PlatformState
+{
+    TARGET_PLATFORM platform = getGenxPlatform();
+    Stepping stepping = GetStepping();
+
+    void install() const
+    {
+        SetVisaPlatform(platform);
+        SetVisaStepping(stepping);
+    }
+};
 
 // Error types
 #define ERROR_UNKNOWN                       "ERROR: Unkown fatal internal error!"
@@ -26,6 +26,29 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "iga_main.hpp"
 
+static iga_assemble_options_t getAssembleOptions(const Opts &opts)
+{
+    iga_assemble_options_t aopts = IGA_ASSEMBLE_OPTIONS_INIT();
+    aopts.enabled_warnings = opts.enabledWarnings;
+
+    setOptBit(aopts.encoder_opts,
+        IGA_ENCODER_OPT_AUTO_COMPACT,
+        opts.autoCompact);
+    setOptBit(aopts.encoder_opts,
+        IGA_ENCODER_OPT_ERROR_ON_COMPACT_FAIL,
+        opts.errorOnCompactFail);
+    setOptBit(aopts.encoder_opts,
+        IGA_ENCODER_OPT_USE_NATIVE,
+        opts.useNativeEncoder);
+    setOptBit(aopts.syntax_opts,
+        IGA_SYNTAX_OPT_LEGACY_SYNTAX,
+        opts.legacyDirectives);
+    setOptBit(aopts.syntax_opts,
+        IGA_SYNTAX_OPT_EXTENSIONS,
+        opts.syntaxExts);
+    return aopts;
+}
+
 bool assemble(
     const Opts &opts,
     igax::Context &ctx,
@@ -36,6 +59,12 @@ bool assemble(
     bool success = assemble(opts, ctx, inpFile, inpText, bits);
     if (success) {
         writeBinary(opts, bits.data(), bits.size());
+        if (opts.timingRuns > 0) {
+            iga_assemble_options_t aopts = getAssembleOptions(opts);
+            reportTiming(opts, inpFile, "assembled", [&] () {
+                ctx.assembleFromString(inpText, aopts);
+            });
+        }
     }
     return success;
 }
@@ -47,25 +76,7 @@ bool assemble(
     const std::string &inpText,
     igax::Bits &bits)
 {
-    iga_assemble_options_t aopts = IGA_ASSEMBLE_OPTIONS_INIT();
-    aopts.enabled_warnings = opts.enabledWarnings;
-
-    setOptBit(aopts.encoder_opts,
-        IGA_ENCODER_OPT_AUTO_COMPACT,
-        opts.autoCompact);
-    setOptBit(aopts.encoder_opts,
-        IGA_ENCODER_OPT_ERROR_ON_COMPACT_FAIL,
-        opts.errorOnCompactFail);
-    setOptBit(aopts.encoder_opts,
-        IGA_ENCODER_OPT_USE_NATIVE,
-        opts.useNativeEncoder);
-    setOptBit(aopts.syntax_opts,
-        IGA_SYNTAX_OPT_LEGACY_SYNTAX,
-        opts.legacyDirectives);
-    setOptBit(aopts.syntax_opts,
-        IGA_SYNTAX_OPT_EXTENSIONS,
-        opts.syntaxExts);
-
+    iga_assemble_options_t aopts = getAssembleOptions(opts);
     try {
         auto r = ctx.assembleFromString(inpText, aopts);
         for (auto &w : r.warnings) {
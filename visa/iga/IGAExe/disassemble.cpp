@@ -56,12 +56,20 @@ bool disassemble(
     setOptBit(dopts.decoder_opts,
         IGA_DECODING_OPT_NATIVE,
         opts.useNativeEncoder);
+    setOptBit(dopts.decoder_opts,
+        IGA_DECODING_OPT_PARALLEL,
+        opts.parallelDecode);
     try {
         auto r = ctx.disassembleToString(inp.data(), inp.size(), dopts);
         for (auto &w : r.warnings) {
             emitWarningToStderr(w, inp);
         }
         writeText(opts, r.value);
+        if (opts.timingRuns > 0) {
+            reportTiming(opts, inpFile, "disassembled", [&] () {
+                ctx.disassembleToString(inp.data(), inp.size(), dopts);
+            });
+        }
         return true;
     } catch (const igax::DisassembleError &err) {
         // some error where we can report several potentially
@@ -26,6 +26,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "iga_main.hpp"
 #include "opts.hpp"
 
+#include <cstdlib>
 #include <iomanip>
 #include <sstream>
 #include <tuple>
@@ -331,6 +332,15 @@ extern "C" int iga_main(int argc, const char **argv)
         "",
         opts::OptAttrs::ALLOW_UNSET,
         baseOpts.useNativeEncoder);
+    xGrp.defineFlag(
+        "parallel",
+        nullptr,
+        "decodes and formats large kernels on multiple threads",
+        "Splits the instruction stream into chunks that are decoded and "
+        "formatted on separate threads. Output is identical to the serial "
+        "disassembler.",
+        opts::OptAttrs::ALLOW_UNSET,
+        baseOpts.parallelDecode);
     xGrp.defineFlag(
         "no-autocompact",
         nullptr,
@@ -394,6 +404,23 @@ extern "C" int iga_main(int argc, const char **argv)
         "Send instructions are emitted as load/store instructions",
         opts::OptAttrs::ALLOW_UNSET,
         baseOpts.printLdSt);
+    xGrp.defineOpt(
+        "time",
+        nullptr,
+        "RUNS",
+        "reports the mean time to assemble or disassemble each input",
+        "After the output is written, the input is assembled or disassembled "
+        "RUNS more times with the same options, and the mean time per run "
+        "is written to stderr.",
+        opts::OptAttrs::ALLOW_UNSET,
+        [] (const char *inp, const opts::ErrorHandler &err, Opts &baseOpts) {
+            char *end = nullptr;
+            long runs = strtol(inp, &end, 10);
+            if (end == inp || *end != 0 || runs <= 0 || runs > INT32_MAX) {
+                err("invalid number of runs");
+            }
+            baseOpts.timingRuns = (int)runs;
+        });
     xGrp.defineFlag(
         "warn-on-compact-fail",
         nullptr,
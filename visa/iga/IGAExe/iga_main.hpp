@@ -33,6 +33,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "api/igax.hpp"
 
 #include <algorithm>
+#include <chrono>
 #include <cstdio>
 #include <cstdint>
 #include <fstream>
@@ -68,6 +69,8 @@ struct Opts {
     bool autosetDepInfo      = false;                // -Xauto-deps
     bool syntaxExts          = false;                // -Xsyntax-exts
     bool useNativeEncoder    = false;                // -Xnative
+    bool parallelDecode      = false;                // -Xparallel
+    int timingRuns           = 0;                    // -Xtime
 
     bool printBits           = false;                // -Xprint-bits
     bool printDeps           = false;                // -Xprint-deps
@@ -140,6 +143,25 @@ static void writeBinary(const Opts &opts, const void *bits, size_t bitsLen) {
     }
 }
 
+// -Xtime: repeats what (an assembly or disassembly of inpFile) and reports
+// the mean time per run to stderr
+template <typename F>
+static void reportTiming(
+    const Opts &opts,
+    const std::string &inpFile,
+    const char *what,
+    F runOnce)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < opts.timingRuns; i++) {
+        runOnce();
+    }
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    std::cerr << inpFile << ": " << what << " " << opts.timingRuns <<
+        " times, " << ((double)us / opts.timingRuns) << " us per run\n";
+}
+
 #define IGA_CALL(F, ...)                                       \
     do {                                                       \
         iga_status_t _st = F(__VA_ARGS__);                     \
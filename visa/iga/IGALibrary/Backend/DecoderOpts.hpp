@@ -30,9 +30,12 @@ namespace iga
 struct DecoderOpts
 {
     bool useNumericLabels;
+    // decode large binaries in chunks on multiple threads
+    bool parallel;
 
-    DecoderOpts(bool _useNumericLabels = false)
+    DecoderOpts(bool _useNumericLabels = false, bool _parallel = false)
         : useNumericLabels(_useNumericLabels)
+        , parallel(_parallel)
     {
     }
 };
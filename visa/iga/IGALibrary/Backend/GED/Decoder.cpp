@@ -32,8 +32,11 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../../IR/IRChecker.hpp"
 #include "../../asserts.hpp"
 
-#include <sstream>
+#include <algorithm>
 #include <cstring>
+#include <sstream>
+#include <thread>
+#include <vector>
 
 // Used to label expressions that need to be removed once GED is fixed
 #define GED_WORKAROUND(X) (X)
@@ -109,24 +112,27 @@ DecoderBase::DecoderBase(const Model &model, ErrorHandler &errHandler) :
 
 Kernel *DecoderBase::decodeKernelBlocks(
     const void *binary,
-    size_t binarySize)
+    size_t binarySize,
+    bool parallel)
 {
-    return decodeKernel(binary, binarySize, false);
+    return decodeKernel(binary, binarySize, false, parallel);
 }
 
 
 Kernel *DecoderBase::decodeKernelNumeric(
     const void *binary,
-    size_t binarySize)
+    size_t binarySize,
+    bool parallel)
 {
-    return decodeKernel(binary, binarySize, true);
+    return decodeKernel(binary, binarySize, true, parallel);
 }
 
 
 Kernel *DecoderBase::decodeKernel(
     const void *binary,
     size_t binarySize,
-    bool numericLabels)
+    bool numericLabels,
+    bool parallel)
 {
     m_binary = binary;
     if (binarySize == 0) {
@@ -141,20 +147,28 @@ Kernel *DecoderBase::decodeKernel(
     Kernel *kernel = new Kernel(m_model);
 
     InstList insts;
-    // NOTE: we could pre-allocate instruction list here
-    // (this would block allocate everything)
-    // insts.reserve(binarySize / 8 + 1);
+    // every instruction takes at least 8 bytes (compacted), so this
+    // bounds the count and the list never grows while decoding
+    insts.reserve(binarySize / 8);
 
     // Pass 1. decode them all into Instruction objects
-    decodeInstructions(
-        *kernel,
-        binary,
-        binarySize,
-        insts);
+    if (parallel) {
+        decodeInstructionsParallel(
+            *kernel,
+            (int32_t)binarySize,
+            insts);
+    } else {
+        decodeInstructions(
+            *kernel,
+            0,
+            (int32_t)binarySize,
+            insts);
+    }
 
     if (numericLabels) {
         Block *block = kernel->createBlock();
         block->setPC(0);
+        block->reserveInstructions(insts.size());
         for (Instruction *inst : insts) {
             block->appendInstruction(inst);
         }
@@ -202,18 +216,124 @@ const OpSpec *DecoderBase::decodeOpSpec(Op op)
     return &m_model.lookupGroupSubOp(op, fcBits);
 }
 
+// decodes the instruction at the current PC; binary points to its bits
+Instruction *DecoderBase::decodeInstruction(
+    Kernel &kernel,
+    const unsigned char *binary,
+    int32_t bytesLeft,
+    int32_t iLen)
+{
+    memset(&m_currGedInst, 0, sizeof(m_currGedInst));
+    GED_RETURN_VALUE status =
+        GED_DecodeIns(m_gedModel, binary, (uint32_t)bytesLeft, &m_currGedInst);
+    Instruction *inst = nullptr;
+    if (status == GED_RETURN_VALUE_NO_COMPACT_FORM) {
+        error("error decoding instruction (no compacted form)");
+        inst = createErrorInstruction(
+            kernel,
+            "unable to decompact",
+            binary,
+            iLen);
+        // fall through: GED can sort of decode some things here
+    } else if (status != GED_RETURN_VALUE_SUCCESS) {
+        error("error decoding instruction");
+        inst = createErrorInstruction(
+            kernel,
+            "GED error decoding instruction",
+            binary,
+            iLen);
+    } else {
+        Op op = GEDToIGATranslation::translate(GED_GetOpcode(&m_currGedInst));
+        m_opSpec = decodeOpSpec(op);
+        if (m_opSpec->op == Op::INVALID) {
+            // figure out if we failed to resolve the primary op
+            // or if it's an unmapped subfunction (e.g. math function)
+            auto os = m_model.lookupOpSpec(op);
+            std::stringstream ss;
+            if (os.format == OpSpec::GROUP) {
+                ss << std::hex <<
+                    "unsupported pseudo op (sub function of " <<
+                    os.mnemonic << ")";
+            } else {
+                ss << std::hex << "0x" << (unsigned)op <<
+                    ": unsupported opcode on this platform";
+            }
+            std::string str = ss.str();
+            error("%s", str.c_str());
+            inst = createErrorInstruction(
+                kernel,
+                str.c_str(),
+                binary,
+                iLen);
+        } else {
+            try {
+                inst = decodeNextInstruction(kernel);
+            } catch (const FatalError &fe) {
+                // error is already logged
+                inst = createErrorInstruction(
+                    kernel,
+                    fe.what(),
+                    binary,
+                    iLen);
+            }
+        }
+    }
+    return inst;
+}
+
+Instruction *DecoderBase::decodeInstructionAt(
+    Kernel &kernel,
+    const void *binary,
+    size_t binarySize,
+    int32_t pc)
+{
+    m_binary = binary;
+    int32_t bytesLeft = (int32_t)binarySize - pc;
+    // need at least 4 bytes to check compaction control
+    if (pc < 0 || bytesLeft < 4) {
+        return nullptr;
+    }
+    restart();
+    advancePc(pc);
+    int32_t iLen = getBitField(COMPACTION_CONTROL,1) != 0 ?
+        COMPACTED_SIZE :
+        UNCOMPACTED_SIZE;
+    if (bytesLeft < iLen) {
+        return nullptr;
+    }
+    Instruction *inst = decodeInstruction(
+        kernel,
+        (const unsigned char *)binary + pc,
+        bytesLeft,
+        iLen);
+    inst->setPC(pc);
+    inst->setLoc(pc);
+    return inst;
+}
+
+int32_t DecoderBase::getInstructionSize(const void *bits)
+{
+    uint32_t dw0;
+    memcpy(&dw0, bits, sizeof(dw0));
+    return ((dw0 >> COMPACTION_CONTROL) & 1) != 0 ?
+        COMPACTED_SIZE :
+        UNCOMPACTED_SIZE;
+}
+
 // Pass 1. decode all instructions in Instruction*
 void DecoderBase::decodeInstructions(
     Kernel &kernel,
-    const void *binaryStart,
-    size_t binarySize,
+    int32_t startPc,
+    int32_t endPc,
     InstList &insts)
 {
     restart();
+    advancePc(startPc);
     uint32_t nextId = 1;
-    const unsigned char *binary = (const unsigned char *)binaryStart;
+    const unsigned char *binary =
+        (const unsigned char *)m_binary + startPc;
 
-    int32_t bytesLeft =  (int32_t)binarySize;
+    int32_t bytesLeft = endPc - startPc;
     while (bytesLeft > 0)
     {
         // need at least 4 bytes to check compaction control
@@ -229,61 +349,7 @@ void DecoderBase::decodeInstructions(
             warning("unexpected padding at end of kernel");
             break;
         }
-        memset(&m_currGedInst, 0, sizeof(m_currGedInst));
-        GED_RETURN_VALUE status =
-            GED_DecodeIns(m_gedModel, binary, (uint32_t)binarySize, &m_currGedInst);
-        Instruction *inst = nullptr;
-        if (status == GED_RETURN_VALUE_NO_COMPACT_FORM) {
-            error("error decoding instruction (no compacted form)");
-            inst = createErrorInstruction(
-                kernel,
-                "unable to decompact",
-                binary,
-                iLen);
-            // fall through: GED can sort of decode some things here
-        } else if (status != GED_RETURN_VALUE_SUCCESS) {
-            error("error decoding instruction");
-            inst = createErrorInstruction(
-                kernel,
-                "GED error decoding instruction",
-                binary,
-                iLen);
-        } else {
-            Op op = GEDToIGATranslation::translate(GED_GetOpcode(&m_currGedInst));
-            m_opSpec = decodeOpSpec(op);
-            if (m_opSpec->op == Op::INVALID) {
-                // figure out if we failed to resolve the primary op
-                // or if it's an unmapped subfunction (e.g. math function)
-                auto os = m_model.lookupOpSpec(op);
-                std::stringstream ss;
-                if (os.format == OpSpec::GROUP) {
-                    ss << std::hex <<
-                        "unsupported pseudo op (sub function of " <<
-                        os.mnemonic << ")";
-                } else {
-                    ss << std::hex << "0x" << (unsigned)op <<
-                        ": unsupported opcode on this platform";
-                }
-                std::string str = ss.str();
-                error("%s", str.c_str());
-                inst = createErrorInstruction(
-                    kernel,
-                    str.c_str(),
-                    binary,
-                    iLen);
-            } else {
-                try {
-                    inst = decodeNextInstruction(kernel);
-                } catch (const FatalError &fe) {
-                    // error is already logged
-                    inst = createErrorInstruction(
-                        kernel,
-                        fe.what(),
-                        binary,
-                        iLen);
-                }
-            }
-        }
+        Instruction *inst = decodeInstruction(kernel, binary, bytesLeft, iLen);
         inst->setPC(currentPc());
         inst->setID(nextId++);
         insts.emplace_back(inst);
@@ -301,6 +367,104 @@ void DecoderBase::decodeInstructions(
 
 }
 
+// each decoder thread gets at least this many bytes
+static const int32_t PARALLEL_DECODE_MIN_CHUNK = 16*1024;
+
+// Pass 1 (parallel). Chunk boundaries are found by walking the compaction
+// bits, so every chunk starts on an instruction.  Each chunk is decoded by
+// its own decoder into its own kernel and error handler; the instructions,
+// IDs and diagnostics are then merged back in PC order so the result is
+// identical to the serial decode.
+void DecoderBase::decodeInstructionsParallel(
+    Kernel &kernel,
+    int32_t binarySize,
+    InstList &insts)
+{
+    int32_t maxChunks = binarySize / PARALLEL_DECODE_MIN_CHUNK;
+    int32_t numChunks = (int32_t)std::thread::hardware_concurrency();
+    numChunks = std::min(numChunks, maxChunks);
+    if (numChunks <= 1) {
+        decodeInstructions(kernel, 0, binarySize, insts);
+        return;
+    }
+
+    const unsigned char *binary = (const unsigned char *)m_binary;
+    const int32_t chunkSize = binarySize / numChunks;
+    std::vector<int32_t> chunkStarts;
+    chunkStarts.push_back(0);
+    int32_t pc = 0;
+    while (pc + 4 <= binarySize &&
+        (int32_t)chunkStarts.size() < numChunks)
+    {
+        if (pc >= chunkSize * (int32_t)chunkStarts.size()) {
+            chunkStarts.push_back(pc);
+        }
+        uint32_t dw0;
+        memcpy(&dw0, binary + pc, sizeof(dw0));
+        pc += ((dw0 >> COMPACTION_CONTROL) & 1) != 0 ?
+            COMPACTED_SIZE :
+            UNCOMPACTED_SIZE;
+    }
+    chunkStarts.push_back(binarySize);
+    numChunks = (int32_t)chunkStarts.size() - 1;
+
+    struct Chunk {
+        Kernel      *kernel;
+        ErrorHandler errors;
+        InstList     insts;
+        bool         fatal = false;
+    };
+    std::vector<Chunk> chunks(numChunks);
+    std::vector<std::thread> workers;
+    workers.reserve(numChunks);
+    for (int32_t i = 0; i < numChunks; i++) {
+        chunks[i].kernel = new Kernel(m_model);
+        workers.emplace_back([&, i] () {
+            Chunk &c = chunks[i];
+            DecoderBase chunkDecoder(m_model, c.errors);
+            chunkDecoder.m_binary = m_binary;
+            try {
+                c.insts.reserve((chunkStarts[i + 1] - chunkStarts[i]) / 8);
+                chunkDecoder.decodeInstructions(
+                    *c.kernel, chunkStarts[i], chunkStarts[i + 1], c.insts);
+            } catch (const FatalError &) {
+                // error is already logged in the chunk's handler
+                c.fatal = true;
+            }
+        });
+    }
+    for (auto &w : workers) {
+        w.join();
+    }
+
+    size_t numInsts = 0;
+    for (const Chunk &c : chunks) {
+        numInsts += c.insts.size();
+    }
+    insts.reserve(numInsts);
+    uint32_t nextId = 1;
+    bool fatal = false;
+    for (Chunk &c : chunks) {
+        for (Instruction *inst : c.insts) {
+            inst->setID(nextId++);
+            insts.emplace_back(inst);
+        }
+        for (const Diagnostic &d : c.errors.getWarnings()) {
+            errorHandler().reportWarning(d.at, d.message);
+        }
+        for (const Diagnostic &d : c.errors.getErrors()) {
+            errorHandler().reportError(d.at, d.message);
+        }
+        kernel.adoptMemory(c.kernel);
+        fatal |= c.fatal;
+    }
+    if (fatal) {
+        // same as the serial decoder: propagate after the diagnostics
+        // are in place
+        throw FatalError();
+    }
+}
+
 void DecoderBase::decodeNextInstructionEpilog(Instruction *inst)
 {
 }
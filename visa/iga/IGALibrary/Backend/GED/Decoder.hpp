@@ -51,25 +51,57 @@ namespace iga
         DecoderBase(const Model &model, ErrorHandler &errHandler);
 
         // the main entry point for decoding a kernel
+        // (parallel splits large binaries into chunks decoded on
+        // separate threads)
         Kernel *decodeKernelBlocks(
             const void *binary,
-            size_t binarySize);
+            size_t binarySize,
+            bool parallel = false);
         Kernel *decodeKernelNumeric(
             const void *binary,
-            size_t binarySize);
+            size_t binarySize,
+            bool parallel = false);
+
+        // decodes the single instruction at pc without block inference
+        // (branch targets stay numeric, relative to pc); the instruction is
+        // allocated in kernel's memory pool.  Returns nullptr if pc is out
+        // of bounds.
+        Instruction *decodeInstructionAt(
+            Kernel &kernel,
+            const void *binary,
+            size_t binarySize,
+            int32_t pc);
+
+        // the size of the instruction starting at 'bits' (8 if compacted,
+        // otherwise 16); reads only the compaction control bit
+        static int32_t getInstructionSize(const void *bits);
 
     private:
         Kernel *decodeKernel(
             const void *binary,
             size_t binarySize,
-            bool numericLabels);
+            bool numericLabels,
+            bool parallel);
 
         // pass 1 decodes instructions with numeric labels
+        // from PC startPc up to endPc (relative to m_binary)
         void decodeInstructions(
             Kernel &kernel,
-            const void *binary,
-            size_t binarySize,
+            int32_t startPc,
+            int32_t endPc,
+            InstList &insts);
+        // pass 1 on several threads; each chunk is decoded into its own
+        // kernel (memory pool) which the given kernel then adopts
+        void decodeInstructionsParallel(
+            Kernel &kernel,
+            int32_t binarySize,
             InstList &insts);
+        // decodes the instruction at the current PC
+        Instruction *decodeInstruction(
+            Kernel &kernel,
+            const unsigned char *binary,
+            int32_t bytesLeft,
+            int32_t iLen);
         const OpSpec *decodeOpSpec(Op op);
 
         Instruction *decodeNextInstruction(Kernel &kernel);
@@ -75,6 +75,8 @@ EncoderBase::EncoderBase(
     , m_opts(opts)
     , m_mem(nullptr)
     , m_numberInstructionsEncoded(0)
+    , m_instBuf(nullptr)
+    , m_instBufLen(0)
 {
 }
 
@@ -180,48 +182,127 @@ void EncoderBase::encodeBlock(Block *blk)
 {
     m_blockToOffsetMap[blk] = currentPc();
     for (const auto inst : blk->getInstList()) {
-        setCurrInst(inst);
-        encodeInstruction(*inst);
+        encodeAndPlaceInstruction(inst);
         if (hasFatalError()) {
             return;
         }
-        setEncodedPC(inst, currentPc());
-
-        GED_RETURN_VALUE status = GED_RETURN_VALUE_SIZE;
-        bool mustCompact = inst->hasInstOpt(InstOpt::COMPACTED);
-        bool mustNotCompact =
-            inst->hasInstOpt(InstOpt::NOCOMPACT);
-        int32_t iLen = 16;
-        if ((mustCompact || !mustNotCompact && m_opts.autoCompact)) {
-            // try compact first
-            status = GED_EncodeIns(&m_gedInst, GED_INS_TYPE_COMPACT, m_instBuf + currentPc());
-            if (status == GED_RETURN_VALUE_SUCCESS) {
-                //If auto compation is turned on, in case we need to patch later.
-                inst->addInstOpt(InstOpt::COMPACTED);
-                iLen = 8;
-            } else if (status == GED_RETURN_VALUE_NO_COMPACT_FORM) {
-                if (mustCompact) {
-                    if (m_opts.explicitCompactMissIsWarning) {
-                        warningAt(inst->getLoc(), "GED unable to compact instruction");
-                    } else {
-                        errorAt(inst->getLoc(), "GED unable to compact instruction");
-                    }
+    }
+}
+
+// encodes inst at the current PC, compacted if possible, and advances the PC
+void EncoderBase::encodeAndPlaceInstruction(Instruction *inst)
+{
+    setCurrInst(inst);
+    encodeInstruction(*inst);
+    if (hasFatalError()) {
+        return;
+    }
+    setEncodedPC(inst, currentPc());
+
+    GED_RETURN_VALUE status = GED_RETURN_VALUE_SIZE;
+    bool mustCompact = inst->hasInstOpt(InstOpt::COMPACTED);
+    bool mustNotCompact =
+        inst->hasInstOpt(InstOpt::NOCOMPACT);
+    int32_t iLen = 16;
+    if ((mustCompact || !mustNotCompact && m_opts.autoCompact)) {
+        // try compact first
+        status = GED_EncodeIns(&m_gedInst, GED_INS_TYPE_COMPACT, m_instBuf + currentPc());
+        if (status == GED_RETURN_VALUE_SUCCESS) {
+            //If auto compation is turned on, in case we need to patch later.
+            inst->addInstOpt(InstOpt::COMPACTED);
+            iLen = 8;
+        } else if (status == GED_RETURN_VALUE_NO_COMPACT_FORM) {
+            if (mustCompact) {
+                if (m_opts.explicitCompactMissIsWarning) {
+                    warningAt(inst->getLoc(), "GED unable to compact instruction");
+                } else {
+                    errorAt(inst->getLoc(), "GED unable to compact instruction");
                 }
-            } // else: some other error (unreachable?)
-        }
+            }
+        } // else: some other error (unreachable?)
+    }
 
-        // try native encoding
+    // try native encoding
+    if (status != GED_RETURN_VALUE_SUCCESS) {
+        inst->removeInstOpt(InstOpt::COMPACTED);
+        status = GED_EncodeIns(&m_gedInst, GED_INS_TYPE_NATIVE, m_instBuf + currentPc());
         if (status != GED_RETURN_VALUE_SUCCESS) {
-            inst->removeInstOpt(InstOpt::COMPACTED);
-            status = GED_EncodeIns(&m_gedInst, GED_INS_TYPE_NATIVE, m_instBuf + currentPc());
-            if (status != GED_RETURN_VALUE_SUCCESS) {
-                errorAt(inst->getLoc(), "GED unable to encode instruction: %s",
-                    gedReturnValueToString(status));
-            }
+            errorAt(inst->getLoc(), "GED unable to encode instruction: %s",
+                gedReturnValueToString(status));
         }
+    }
+
+    advancePc(iLen);
+}
+
+void EncoderBase::beginStream(MemManager &mem, size_t maxInstructions)
+{
+    initIGATimer();
+    setIGAKernelName("test");
+    restart();
+    m_needToPatch.clear();
+    m_blockToOffsetMap.clear();
+    m_mem = &mem;
+    m_numberInstructionsEncoded = 0;
+    m_instBufLen = maxInstructions * UNCOMPACTED_SIZE;
+    if (m_instBufLen == 0) // for empty kernel case
+        m_instBufLen = 4;
+    m_instBuf = (uint8_t *)mem.alloc(m_instBufLen);
+#ifndef DISABLE_ENCODER_EXCEPTIONS
+    try {
+#endif
+        if (!m_instBuf) {
+            fatalAt(0, "failed to allocate memory for kernel binary");
+        }
+#ifndef DISABLE_ENCODER_EXCEPTIONS
+    } catch (const iga::FatalError&) {
+        // error is already reported
+    }
+#endif
+}
 
-        advancePc(iLen);
+void EncoderBase::markStreamBlock(const Block *blk)
+{
+    m_blockToOffsetMap[blk] = currentPc();
+}
+
+void EncoderBase::encodeStreamInstruction(Instruction &inst)
+{
+    IGA_ASSERT((size_t)currentPc() + UNCOMPACTED_SIZE <= m_instBufLen,
+        "more instructions than the stream was started with");
+#ifndef DISABLE_ENCODER_EXCEPTIONS
+    try {
+#endif
+        START_ENCODER_TIMER()
+        encodeAndPlaceInstruction(&inst);
+        STOP_ENCODER_TIMER()
+        m_numberInstructionsEncoded++;
+#ifndef DISABLE_ENCODER_EXCEPTIONS
+    } catch (const iga::FatalError&) {
+        // error is already reported
     }
+#endif
+}
+
+void EncoderBase::endStream(void *&bits, uint32_t &bitsLen)
+{
+#ifndef DISABLE_ENCODER_EXCEPTIONS
+    try {
+#endif
+        START_ENCODER_TIMER()
+        patchJumpOffsets();
+        STOP_ENCODER_TIMER()
+
+        bitsLen = currentPc();
+        bits = m_instBuf;
+
+        // clear any padding
+        memset(m_instBuf + bitsLen, 0, m_instBufLen - bitsLen);
+#ifndef DISABLE_ENCODER_EXCEPTIONS
+    } catch (const iga::FatalError&) {
+        // error is already reported
+    }
+#endif
 }
 
 bool EncoderBase::getBlockOffset(const Block *b, uint32_t &pc)
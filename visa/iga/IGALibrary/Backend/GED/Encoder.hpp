@@ -43,8 +43,6 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 namespace iga
 {
-    typedef list<Block *, std_arena_based_allocator<Block*>> BlockList;
-
     class EncoderBase : protected GEDBitProcessor
     {
     public:
@@ -59,6 +57,16 @@ namespace iga
             void*& bits,
             uint32_t& bitsLen);
 
+        // Streaming interface for producers that build no Kernel. The
+        // instructions are encoded one at a time in layout order, each block
+        // that is a jump target is marked where it starts, and endStream
+        // patches the jump offsets. Only the branching instructions have to
+        // stay alive until endStream.
+        void beginStream(MemManager &m, size_t maxInstructions);
+        void markStreamBlock(const Block *blk);
+        void encodeStreamInstruction(Instruction &inst);
+        void endStream(void*& bits, uint32_t& bitsLen);
+
         size_t getNumInstructionsEncoded() const;
 
         ///////////////////////////////////////////////////////////////////////
@@ -145,6 +153,7 @@ namespace iga
         void *operator new(size_t sz, MemManager* m) { return m->alloc(sz); };
 
         void encodeBlock(Block *blk);
+        void encodeAndPlaceInstruction(Instruction *inst);
         void encodeInstruction(Instruction& inst);
         void patchJumpOffsets();
 
@@ -208,6 +217,7 @@ namespace iga
         // state valid over encodeKernel()
         MemManager                               *m_mem;
         uint8_t                                  *m_instBuf; // the output bits
+        size_t                                    m_instBufLen;
         struct JumpPatch { // JIP and UIP label patching
             Instruction    *inst; // the instruction
             ged_ins_t       gedInst; // the partially constructed GED instruction
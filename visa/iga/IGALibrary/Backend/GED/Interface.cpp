@@ -75,8 +75,8 @@ Kernel *iga::ged::Decode(
     try {
         iga::Decoder decoder(m, eh);
         k = dopts.useNumericLabels ?
-            decoder.decodeKernelNumeric(bits, bitsLen) :
-            decoder.decodeKernelBlocks(bits, bitsLen);
+            decoder.decodeKernelNumeric(bits, bitsLen, dopts.parallel) :
+            decoder.decodeKernelBlocks(bits, bitsLen, dopts.parallel);
     } catch (FatalError) {
         // error already reported
     }
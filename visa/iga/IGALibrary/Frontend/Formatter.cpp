@@ -44,6 +44,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <cstring>
 #include <iomanip>
 #include <sstream>
+#include <thread>
 #include <vector>
 
 // shows formatting output in realtime to stderr (for stepping through code)
@@ -138,10 +139,25 @@ public:
     void formatKernel(
         const Kernel& k,
         const void *vbits)
+    {
+        formatBlocks(
+            k.getBlockList().begin(),
+            k.getBlockList().end(),
+            vbits);
+    }
+
+
+    // formats a contiguous range of blocks; vbits (if given) points to the
+    // encoding of the first instruction of the first block
+    void formatBlocks(
+        BlockList::const_iterator begin,
+        BlockList::const_iterator end,
+        const void *vbits)
     {
         bits = (const uint8_t *)vbits;
 
-        for (const Block *b : k.getBlockList()) {
+        for (auto bItr = begin; bItr != end; ++bItr) {
+            const Block *b = *bItr;
             if (!opts.numericLabels) {
                 formatLabel(b->getPC());
                 emit(':');
@@ -986,6 +1002,78 @@ void FormatKernel(
 }
 
 
+// each formatter thread gets at least this many instructions
+static const size_t PARALLEL_FORMAT_MIN_INSTS = 2048;
+
+void FormatKernelParallel(
+    ErrorHandler& e,
+    std::ostream& o,
+    const FormatOpts& opts,
+    const Kernel& k,
+    const void *bits)
+{
+    IGA_ASSERT(k.getModel().platform == opts.platform,
+        "kernel and options must have same platform");
+    size_t maxRanges = k.getInstructionCount() / PARALLEL_FORMAT_MIN_INSTS;
+    size_t numRanges = std::min(
+        (size_t)std::thread::hardware_concurrency(), maxRanges);
+    if (opts.labeler || numRanges <= 1) {
+        // user labelers need not be thread safe
+        FormatKernel(e, o, opts, k, bits);
+        return;
+    }
+
+    // split the block list into contiguous ranges of about the same
+    // number of instructions
+    struct Range {
+        BlockList::const_iterator begin, end;
+        ErrorHandler              errors;
+        std::stringstream         text;
+    };
+    std::vector<Range> ranges(numRanges);
+    const BlockList &bl = k.getBlockList();
+    size_t rangeInsts = k.getInstructionCount() / numRanges;
+    size_t numInsts = 0, r = 0;
+    ranges[0].begin = bl.begin();
+    for (auto bItr = bl.begin(); bItr != bl.end(); ++bItr) {
+        if (r + 1 < numRanges && numInsts >= rangeInsts * (r + 1)) {
+            ranges[r].end = bItr;
+            ranges[++r].begin = bItr;
+        }
+        numInsts += (*bItr)->getInstList().size();
+    }
+    ranges[r].end = bl.end();
+    numRanges = r + 1;
+
+    std::vector<std::thread> workers;
+    workers.reserve(numRanges);
+    for (size_t i = 0; i < numRanges; i++) {
+        workers.emplace_back([&, i] () {
+            Range &rng = ranges[i];
+            const uint8_t *rangeBits = nullptr;
+            if (bits && rng.begin != rng.end) {
+                rangeBits = (const uint8_t *)bits + (*rng.begin)->getPC();
+            }
+            Formatter f(rng.errors, rng.text, opts);
+            f.formatBlocks(rng.begin, rng.end, rangeBits);
+        });
+    }
+    for (auto &w : workers) {
+        w.join();
+    }
+
+    for (size_t i = 0; i < numRanges; i++) {
+        o << ranges[i].text.str();
+        for (const Diagnostic &d : ranges[i].errors.getWarnings()) {
+            e.reportWarning(d.at, d.message);
+        }
+        for (const Diagnostic &d : ranges[i].errors.getErrors()) {
+            e.reportError(d.at, d.message);
+        }
+    }
+}
+
+
 void FormatInstruction(
     ErrorHandler& e,
     std::ostream& o,
@@ -93,6 +93,16 @@ namespace iga {
         const Kernel &k,
         const void *bits = nullptr);
 
+    // Same as FormatKernel, but splits the block list into contiguous
+    // ranges formatted on separate threads.  Small kernels and kernels
+    // formatted with a labeler callback are formatted serially.
+    void FormatKernelParallel(
+        ErrorHandler &e,
+        std::ostream &o,
+        const FormatOpts &opts,
+        const Kernel &k,
+        const void *bits = nullptr);
+
     void FormatInstruction(
         ErrorHandler &e,
         std::ostream &o,
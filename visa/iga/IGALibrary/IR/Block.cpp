@@ -48,7 +48,7 @@ struct BlockInference
     Block *getBlock(int32_t pc) {
         auto itr = blockStarts.find(pc);
         if (itr == blockStarts.end()) {
-            Block *blk      = new (allocator) Block(pc);
+            Block *blk      = new (allocator) Block(allocator, pc);
             blockStarts[pc] = blk;
             return blk;
         } else {
@@ -128,10 +128,29 @@ struct BlockInference
             pc += instLen;
         }
 
-        // for each block, we need to append the following instructions
+        // size each block's instruction array so appending doesn't regrow it
         pc               = 0;
         auto bitr        = blockStarts.begin();
         Block *currBlock = bitr->second;
+        size_t currCount = 0;
+        bitr++;
+        for (Instruction *inst : insts) {
+            int32_t instLen = inst->hasInstOpt(InstOpt::COMPACTED) ? 8 : 16;
+            if (bitr != blockStarts.end() && pc >= bitr->first) {
+                currBlock->reserveInstructions(currCount);
+                currBlock = bitr->second;
+                currCount = 0;
+                bitr++;
+            }
+            currCount++;
+            pc += instLen;
+        }
+        currBlock->reserveInstructions(currCount);
+
+        // for each block, we need to append the following instructions
+        pc               = 0;
+        bitr             = blockStarts.begin();
+        currBlock        = bitr->second;
         bitr++;
 
         for (Instruction *inst : insts) {
@@ -223,9 +242,32 @@ std::map<int32_t, Block *> Block::inferBlocks(
     return blockStarts;
 }
 
-void Block::insertInstBefore(
-    InstList::iterator itr,
-    Instruction *i)
+void Block::insertInstBefore(size_t pos, Instruction *inst)
 {
-    m_instructions.insert(itr, i);
-}
\ No newline at end of file
+    IGA_ASSERT(pos <= m_instructions.size(), "insertion point out of range");
+    m_instructions.insert(m_instructions.begin() + pos, inst);
+    if (!m_instIndex.empty()) {
+        // the tail moved up by one
+        for (size_t i = pos; i < m_instructions.size(); i++) {
+            m_instIndex[m_instructions[i]] = (int)i;
+        }
+    }
+}
+
+int Block::getInstIndex(const Instruction *inst) const
+{
+    auto itr = m_instIndex.find(inst);
+    if (itr != m_instIndex.end() &&
+        itr->second < (int)m_instructions.size() &&
+        m_instructions[itr->second] == inst)
+    {
+        return itr->second;
+    }
+    // the list was changed behind our back (or inst isn't here)
+    m_instIndex.clear();
+    for (size_t i = 0; i < m_instructions.size(); i++) {
+        m_instIndex[m_instructions[i]] = (int)i;
+    }
+    itr = m_instIndex.find(inst);
+    return itr == m_instIndex.end() ? -1 : itr->second;
+}
@@ -36,20 +36,27 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Instruction.hpp"
 
 #include <map>
-#include <list>
+#include <unordered_map>
+#include <vector>
 
 namespace iga
 {
-    typedef std::list<
+    // Instructions are stored contiguously (pointer array in the kernel's
+    // arena) so that traversals do not chase list nodes; an instruction's
+    // index in its block is stable until an insertion before it.
+    typedef std::vector<
        iga::Instruction*, std_arena_based_allocator<iga::Instruction*> > InstList;
     typedef InstList::iterator InstListIterator;
 
     class Block
     {
     public:
-        Block(int32_t pc = -1, const Loc &loc = Loc::INVALID)
+        // 'mem' is the arena the block is allocated in; the instruction
+        // array is allocated there as well
+        Block(MemManager *mem, int32_t pc = -1, const Loc &loc = Loc::INVALID)
             : m_offset(pc)
             , m_loc(loc)
+            , m_instructions(InstList::allocator_type(mem))
             , m_id(pc)
         {
         }
@@ -67,6 +74,21 @@ namespace iga
 
         void appendInstruction(Instruction *inst) {
             m_instructions.push_back(inst);
+            if (!m_instIndex.empty()) {
+                m_instIndex[inst] = (int)m_instructions.size() - 1;
+            }
+        }
+        // inserts before the instruction at index 'pos' (the list's size
+        // appends); indices at and after 'pos' shift up by one
+        void insertInstBefore(size_t pos, Instruction *inst);
+        void insertInstBefore(InstListIterator itr, Instruction *inst) {
+            insertInstBefore((size_t)(itr - m_instructions.begin()), inst);
+        }
+        // the index of 'inst' in this block, or -1 if it isn't in the block
+        int getInstIndex(const Instruction *inst) const;
+        // pre-sizes the instruction array when the count is known
+        void reserveInstructions(size_t n) {
+            m_instructions.reserve(n);
         }
 
         PC                 getPC() const { return m_offset; }
@@ -77,8 +99,6 @@ namespace iga
         int                getID() const { return m_id; }
         const InstList&    getInstList() const { return m_instructions; }
               InstList&    getInstList()       { return m_instructions; }
-        void               insertInstBefore(InstList::iterator iter,
-                                            Instruction *inst);
 
         // infers the control flow graph
         // sets the Block* within these instructions
@@ -93,6 +113,10 @@ namespace iga
         Loc                 m_loc; // optional src location
         InstList            m_instructions;
         int                 m_id;
+        // instruction to index in m_instructions; built on the first
+        // lookup and kept up to date by insertInstBefore (an entry is
+        // only trusted if the list still holds the instruction there)
+        mutable std::unordered_map<const Instruction *,int> m_instIndex;
 
         Block(const Block &) = delete;
         Block& operator=(const Block&) = delete;
@@ -112,11 +112,14 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "DUAnalysis.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <cstdio>
 #include <list>
 #include <map>
+#include <memory>
 #include <sstream>
 #include <string>
+#include <thread>
 
 using namespace iga;
 
@@ -151,11 +154,29 @@ struct BlockState
     LiveDepMap                                 liveIn;
     LiveDepMap                                 liveOut;
 
+    // block summary: the ID of the first instruction (IDs are contiguous
+    // within a block) and every register byte any instruction writes
+    int                                        firstInstId = 0;
+    RegSet                                     defs;
+
+    // the deps completed in this block (in discovery order)
+    std::vector<Dep>                           deps;
+
     BlockState(Block *b) : block(b) { }
+
+    bool ownsInst(const Instruction *i) const {
+        return i->getID() >= firstInstId &&
+            i->getID() < firstInstId + (int)block->getInstList().size();
+    }
 };
 
 
-struct DepAnalysisComputer
+// kernels with fewer instructions per thread than this are summarized
+// and completed serially
+static const size_t PARALLEL_MIN_INSTS = 4096;
+
+
+struct iga::DepAnalysisComputer
 {
     const Model                     &model;
     Kernel                          *k;
@@ -165,41 +186,99 @@ struct DepAnalysisComputer
     // mid-state and then output
     std::vector<BlockState>          blockState;
 
-    // outputs
-    std::vector<Dep>           liveRangesResult;
-
     DepAnalysisComputer(Kernel *_k)
         : model(_k->getModel())
         , k(_k)
     {
-        instSrcs.reserve(k->getInstructionCount());
-        instDsts.reserve(k->getInstructionCount());
-
         blockState.reserve(k->getBlockList().size());
-        int bIx = 0, iIx = 0;
+        for (Block *b : k->getBlockList()) {
+            blockState.emplace_back(b);
+        }
 
         // pre-assign ID's we know to be valid
         TRACE("******** INITIAL CONDITIONS **********\n");
-        for (Block *b : k->getBlockList()) {
-            blockState.emplace_back(b);
-            b->setID(bIx++);
-            TRACE("  BLOCK #%d\n", b->getID());
+        assignIds();
+        std::vector<BlockState *> all;
+        all.reserve(blockState.size());
+        for (BlockState &bs : blockState) {
+            all.push_back(&bs);
+        }
+        forEachBlock(all, [&] (BlockState &bs) {summarizeBlock(bs);});
+
+        computePredecessors();
+    }
 
-            for (Instruction *i : b->getInstList()) {
+    // numbers blocks and instructions in order and sizes the per
+    // instruction summaries
+    void assignIds() {
+        int bIx = 0, iIx = 0;
+        for (BlockState &bs : blockState) {
+            bs.block->setID(bIx++);
+            bs.firstInstId = iIx;
+            for (Instruction *i : bs.block->getInstList()) {
                 i->setID(iIx++);
+            }
+        }
+        instSrcs.resize(iIx);
+        instDsts.resize(iIx);
+    }
 
-                instSrcs.emplace_back(InstSrcs::compute(*i));
-                instDsts.emplace_back(InstDsts::compute(*i));
+    // computes the instruction input and output sets; this only touches
+    // state owned by the block (and its instructions' slots)
+    void summarizeBlock(BlockState &bs) {
+        TRACE("  BLOCK #%d\n", bs.block->getID());
+        bs.defs.reset();
+        for (Instruction *i : bs.block->getInstList()) {
+            instSrcs[i->getID()] = InstSrcs::compute(*i);
+            instDsts[i->getID()] = InstDsts::compute(*i);
+            bs.defs.destructiveUnion(instDsts[i->getID()].unionOf());
+
+            TRACE("    DEF #%03d |  %-96s ||  %s <== %s\n",
+                i->getID(),
+                i->str(model.platform).c_str(),
+                instDsts[i->getID()].str().c_str(),
+                instSrcs[i->getID()].str().c_str());
+        }
+    }
 
-                TRACE("    DEF #%03d |  %-96s ||  %s <== %s\n",
-                    i->getID(),
-                    i->str(model.platform).c_str(),
-                    instDsts.back().str().c_str(),
-                    instSrcs.back().str().c_str());
+    // runs f on each block; large kernels spread the blocks over threads
+    // (f may only modify state owned by the block it is given)
+    template <typename F>
+    void forEachBlock(const std::vector<BlockState *> &bss, F f) {
+        size_t numInsts = 0;
+        for (const BlockState *bs : bss) {
+            numInsts += bs->block->getInstList().size();
+        }
+        size_t numThreads = std::min(
+            (size_t)std::thread::hardware_concurrency(),
+            numInsts / PARALLEL_MIN_INSTS);
+        if (numThreads <= 1) {
+            for (BlockState *bs : bss) {
+                f(*bs);
             }
+            return;
         }
+        std::atomic<size_t> nextBlock(0);
+        std::vector<std::thread> workers;
+        workers.reserve(numThreads);
+        for (size_t t = 0; t < numThreads; t++) {
+            workers.emplace_back([&] () {
+                size_t ix;
+                while ((ix = nextBlock++) < bss.size()) {
+                    f(*bss[ix]);
+                }
+            });
+        }
+        for (auto &w : workers) {
+            w.join();
+        }
+    }
 
-        // pre-calculate predecessor blocks
+    // pre-calculate predecessor blocks
+    void computePredecessors() {
+        for (BlockState &b : blockState) {
+            b.pred.clear();
+        }
         for (size_t i = 0; i < blockState.size(); i++) {
             BlockState &b = blockState[i];
 
@@ -222,8 +301,8 @@ struct DepAnalysisComputer
                     // stop the block hard
                     const Instruction *iTerm = il.back();
                     bool unconditionalJmp =
-                        iTerm->getOp() != Op::JMPI || iTerm->hasPredication();
-                    bool eotTerm =!iTerm->hasInstOpt(InstOpt::EOT);
+                        iTerm->getOp() == Op::JMPI && !iTerm->hasPredication();
+                    bool eotTerm = iTerm->hasInstOpt(InstOpt::EOT);
                     if (!unconditionalJmp && !eotTerm) {
                         // normal fallthrough
                         blockState[i + 1].pred.emplace_back(&b, false);
@@ -244,31 +323,106 @@ struct DepAnalysisComputer
     }
 
     void runAnalysis() {
-        computeLiveInPaths();
-        completePaths();
+        std::vector<BlockState *> all;
+        all.reserve(blockState.size());
+        for (BlockState &bs : blockState) {
+            all.push_back(&bs);
+        }
+        computeLiveInPaths(all);
+        completePaths(all);
     }
 
+    // Re-solves the analysis after the instructions of block 'edited'
+    // changed.  Only blocks that can reach the edited block (the edited
+    // block and its transitive predecessors) can see different live-outs;
+    // those are reset, re-seeded from their unaffected successors and
+    // iterated to a fixed point again.  All others keep their results.
+    void runIncremental(const Block *edited) {
+        IGA_ASSERT(blockState.size() == k->getBlockList().size(),
+            "the kernel's blocks changed since the analysis ran");
+        BlockState &eb = blockState[edited->getID()];
+        IGA_ASSERT(eb.block == edited, "block is not in the analysis");
+
+        size_t oldInstCount = instSrcs.size();
+        assignIds();
+        if (instSrcs.size() == oldInstCount) {
+            summarizeBlock(eb);
+        } else {
+            // instruction IDs shifted; every summary slot moved
+            std::vector<BlockState *> all;
+            all.reserve(blockState.size());
+            for (BlockState &bs : blockState) {
+                all.push_back(&bs);
+            }
+            forEachBlock(all, [&] (BlockState &bs) {summarizeBlock(bs);});
+        }
 
-    void computeLiveInPaths() {
+        std::vector<bool> affected(blockState.size(), false);
+        std::vector<BlockState *> affectedBlocks, worklist(1, &eb);
+        affected[edited->getID()] = true;
+        while (!worklist.empty()) {
+            BlockState *bs = worklist.back();
+            worklist.pop_back();
+            affectedBlocks.push_back(bs);
+            for (auto &predEdge : bs->pred) {
+                int pIx = predEdge.first->block->getID();
+                if (!affected[pIx]) {
+                    affected[pIx] = true;
+                    worklist.push_back(predEdge.first);
+                }
+            }
+        }
+        // keep block order so the iteration (and dep order) matches a
+        // full run
+        std::sort(affectedBlocks.begin(), affectedBlocks.end(),
+            [] (const BlockState *b1, const BlockState *b2) {
+                return b1 < b2;
+            });
+
+        for (BlockState *bs : affectedBlocks) {
+            bs->liveIn.clear();
+            bs->liveOut.clear();
+            bs->deps.clear();
+        }
+        // unaffected successors still flow into affected blocks
+        for (BlockState &bs : blockState) {
+            if (affected[bs.block->getID()])
+                continue;
+            for (auto &predEdge : bs.pred) {
+                if (affected[predEdge.first->block->getID()]) {
+                    joinBlocks(
+                        predEdge.first->liveOut, bs.liveIn, predEdge.second);
+                }
+            }
+        }
+
+        computeLiveInPaths(affectedBlocks);
+        completePaths(affectedBlocks);
+    }
+
+
+    void computeLiveInPaths(const std::vector<BlockState *> &bss) {
         bool changed;
         int itr = 0;
         do {
             TRACE("******* STARTING LIVE-IN ITERATION %d\n", itr);
             changed = false;
-            for (BlockState &bs : blockState) {
-                TRACE("  *** BLOCK %d with ...\n", bs.block->getID());
-                EmitPaths(bs.liveIn);
-                changed |= iterateBlockLiveIn(bs, false);
+            for (BlockState *bs : bss) {
+                TRACE("  *** BLOCK %d with ...\n", bs->block->getID());
+                EmitPaths(bs->liveIn);
+                changed |= iterateBlockLiveIn(*bs, false);
             }
             itr++;
             TRACE("\n");
         } while (changed);
     }
-    void completePaths() {
-        // copy out the data
-        for (BlockState &b : blockState) {
+    void completePaths(const std::vector<BlockState *> &bss) {
+        // copy out the data; at the fixed point this only writes
+        // the block's own deps, so blocks can be completed in parallel
+        forEachBlock(bss, [&] (BlockState &b) {
+            b.deps.clear();
             iterateBlockLiveIn(b, true);
-        }
+        });
     }
 
     bool iterateBlockLiveIn(
@@ -276,13 +430,27 @@ struct DepAnalysisComputer
         bool copyOut)
     {
         // all the live paths at the end of this block
-        LiveDepMap rLiveDefs = b.liveOut;
+        LiveDepMap rLiveDefs;
+        // paths this block never writes just pass through it (only their
+        // distance grows); we need not walk them through every instruction
+        LiveDepMap passThrough;
+        auto &il = b.block->getInstList();
+        for (const auto &lrElem : b.liveOut) {
+            const Dep &d = lrElem.second;
+            if (!d.live.empty() &&
+                !d.live.intersects(b.defs) &&
+                !b.ownsInst(lrElem.first.second))
+            {
+                passThrough.emplace_hint(passThrough.end(), lrElem);
+            } else {
+                rLiveDefs.emplace_hint(rLiveDefs.end(), lrElem);
+            }
+        }
 
         // FOR each instruction i
         //   extend paths backwards
         //   remove any paths killed off by a definition
         //   start any new paths induced by i's uses
-        auto &il = b.block->getInstList();
         for (InstList::reverse_iterator
             iItr = il.rbegin(),
             iItrEnd = il.rend();
@@ -298,13 +466,23 @@ struct DepAnalysisComputer
                 dItr = rLiveDefs.begin(),
                 dEnd = rLiveDefs.end();
             while (dItr != dEnd) {
-                dItr = extenedDepBackwards(i, rLiveDefs, dItr, copyOut);
+                dItr = extenedDepBackwards(
+                    i, rLiveDefs, dItr, copyOut ? &b.deps : nullptr);
             } // live ranges while
 
             // any use of a variable starts a new live range
             startNewDepsBackwards(i, rLiveDefs);
             iItr++;
         }
+        for (auto &lrElem : passThrough) {
+            lrElem.second.minInOrderDist += (int)il.size();
+            rLiveDefs.emplace(lrElem);
+        }
+
+        if (copyOut) {
+            // the live-in is already at its fixed point
+            return false;
+        }
 
         bool bLiveInChanged = updateLiveDefs(b.liveIn, rLiveDefs);
         bool changedAnyPred = false;
@@ -326,7 +504,7 @@ struct DepAnalysisComputer
         Instruction *i,
         LiveDepMap &rLiveDefs,
         LiveDepMap::iterator &dItr,
-        bool copyOut)
+        std::vector<Dep> *copyOut)
     {
         const InstDsts &iOups = instDsts[i->getID()];
         Dep &d = dItr->second;
@@ -334,12 +512,11 @@ struct DepAnalysisComputer
         RegSet overlap;
         d.live.intersectInto(iOups.unionOf(), overlap);
         if (copyOut && !overlap.empty()) {
-            liveRangesResult.push_back(d);
-            Dep &d = liveRangesResult.back();
+            copyOut->push_back(d);
+            Dep &d = copyOut->back();
             d.def = i;
             d.live = overlap;
         }
-
         if (!i->hasPredication()) {
             // don't subtract if the instruction is predicated
             // since there could be another definition above this
@@ -400,11 +577,12 @@ struct DepAnalysisComputer
         } else {
             auto val = rLiveDefs.emplace(DepKey(type,i),Dep(type,i));
             d = &(*val.first).second;
-            d->minInOrderDist = 1;
-            d->crossesBranch = false;
         }
 
-        // clobber the old value.
+        // clobber the old value; a path that came around a loop back to
+        // its own use restarts here
+        d->minInOrderDist = 1;
+        d->crossesBranch = false;
         d->live.reset();
         if (rs1) {
             d->live.destructiveUnion(*rs1);
@@ -428,7 +606,9 @@ struct DepAnalysisComputer
                 // clean insertion
                 Dep copy = lrSuccIN;
                 copy.crossesBranch = true;
-                predOUT[lrElem.first] = copy;
+                // N.b. Dep's assignment operator doesn't assign; construct
+                // the entry in place so the path isn't dropped
+                predOUT.emplace(lrElem.first, copy);
                 changed = true;
             } else {
                 // mutation of existing path
@@ -453,22 +633,6 @@ struct DepAnalysisComputer
             to = from;
         return changed;
     }
-
-    void addDep(
-        const Dep &lr,
-        Instruction *use,
-        Dep::Type type)
-    {
-        liveRangesResult.push_back(lr);
-        Dep &lr1 = liveRangesResult.back();
-        lr1.use = use;
-        lr1.useType = type;
-
-
-        std::stringstream ss;
-        lr1.str(ss);
-        TRACE("  => %s\n", ss.str().c_str());
-    }
 };
 
 // RAR{@3, #5 <- ?, r13..r14}
@@ -519,14 +683,14 @@ bool iga::Dep::operator==(const Dep &p) const
 }
 
 
-DepAnalysis iga::ComputeDepAnalysis(Kernel *k)
+// copies the analysis state out into the public-facing structures
+static void copyOutAnalysis(DepAnalysisComputer &lac, DepAnalysis &la)
 {
-    DepAnalysisComputer lac(k);
-    lac.runAnalysis();
-
-    DepAnalysis la;
+    la.blockInfo.clear();
+    la.deps.clear();
 
     // copy out block information
+    la.blockInfo.reserve(lac.blockState.size());
     for (const auto &bs : lac.blockState) {
         TRACE("==== BLOCK %d LIVE-IN ====\n", bs.block->getID());
         EmitPaths(bs.liveIn);
@@ -547,13 +711,36 @@ DepAnalysis iga::ComputeDepAnalysis(Kernel *k)
         addSet(bs.liveOut, bi.liveDefsOut);
     }
 
-    // copy out the per-instruction live sets
-    for (const Dep &d : lac.liveRangesResult) {
-        if (d.def != nullptr || d.useType != Dep::WRITE) {
-            la.deps.push_back(d);
+    // copy out the per-instruction live sets (in block order)
+    for (const auto &bs : lac.blockState) {
+        for (const Dep &d : bs.deps) {
+            if (d.def != nullptr || d.useType != Dep::WRITE) {
+                la.deps.push_back(d);
+            }
         }
     }
 
     TRACE("=========== END ===========\n");
+}
+
+
+DepAnalysis iga::ComputeDepAnalysis(Kernel *k, bool incremental)
+{
+    auto lac = std::make_shared<DepAnalysisComputer>(k);
+    lac->runAnalysis();
+
+    DepAnalysis la;
+    copyOutAnalysis(*lac, la);
+    if (incremental) {
+        la.state = lac;
+    }
     return la;
 }
+
+
+void iga::UpdateDepAnalysis(DepAnalysis &la, const Block *edited)
+{
+    IGA_ASSERT(la.state, "analysis not computed for incremental updates");
+    la.state->runIncremental(edited);
+    copyOutAnalysis(*la.state, la);
+}
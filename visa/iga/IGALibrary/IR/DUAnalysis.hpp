@@ -30,6 +30,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../IR/RegSet.hpp"
 #include "../IR/Kernel.hpp"
 
+#include <memory>
 #include <ostream>
 #include <string>
 #include <vector>
@@ -99,16 +100,28 @@ namespace iga
         // BlockInfo(BlockInfo &&) = default;
     };
 
+    struct DepAnalysisComputer;
+
     struct DepAnalysis
     {
         // could just use BlockInfo here
         std::vector<BlockInfo>   blockInfo;
         // relation of definitions and all possible uses
         std::vector<Dep>         deps;
+        // solver state kept for UpdateDepAnalysis (null unless requested)
+        std::shared_ptr<DepAnalysisComputer> state;
     };
 
-    // the primary entry point for the live analysis
-    DepAnalysis ComputeDepAnalysis(Kernel *k);
+    // the primary entry point for the live analysis; the solver state is
+    // only kept (for UpdateDepAnalysis) if 'incremental' is set
+    DepAnalysis ComputeDepAnalysis(Kernel *k, bool incremental = false);
+
+    // Updates an analysis after instructions in block 'edited' were changed,
+    // inserted or removed.  Only the edited block and the blocks that can
+    // reach it are solved again.  The edit must not add or remove blocks or
+    // change branch targets, and the kernel must still be alive.  The
+    // analysis must have been computed with 'incremental' set.
+    void UpdateDepAnalysis(DepAnalysis &la, const Block *edited);
 } // namespace IGA
 
 #endif // _IGA_IR_ANALYSIS_HPP
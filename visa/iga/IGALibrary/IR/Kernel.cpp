@@ -31,6 +31,7 @@ using namespace iga;
 Kernel::Kernel(const Model &model)
   : m_model(model)
   , m_mem(4096)
+  , m_blocks(BlockList::allocator_type(&m_mem))
 {
 }
 
@@ -38,12 +39,17 @@ Kernel::~Kernel()
 {
     // Since in a kernel blocks are allocated using the memory pool,
     // when the Kernel was freed, the memory pool was deleted and destructors
-    // for Blocks are never called.  This means the InstList's memory pool
-    // was never deleted and we need to do it here.
+    // for Blocks are never called.  This means the Instructions (and the
+    // blocks' index maps) were never destroyed and we need to do it here.
     for (auto bb : m_blocks)
     {
         bb->~Block();
     }
+    // the blocks may have referenced instructions in adopted pools
+    for (auto k : m_adopted)
+    {
+        delete k;
+    }
 }
 
 size_t Kernel::getInstructionCount() const
@@ -58,7 +64,7 @@ size_t Kernel::getInstructionCount() const
 
 Block *Kernel::createBlock()
 {
-    return new(&m_mem)Block();
+    return new(&m_mem)Block(&m_mem);
 }
 
 
@@ -68,6 +74,14 @@ void Kernel::appendBlock(Block *blk)
 }
 
 
+void Kernel::adoptMemory(Kernel *k)
+{
+    IGA_ASSERT(k->getBlockList().empty(),
+        "adopted kernels must not own blocks");
+    m_adopted.push_back(k);
+}
+
+
 Instruction *Kernel::createBasicInstruction(
     const OpSpec &op,
     const Predication &predOpnd,
@@ -37,10 +37,10 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Block.hpp"
 #include "Instruction.hpp"
 
-#include <list>
+#include <vector>
 
 namespace iga {
-    typedef std::list<
+    typedef std::vector<
         iga::Block*, std_arena_based_allocator<iga::Block*>> BlockList;
 
     class Kernel
@@ -68,6 +68,11 @@ namespace iga {
         Block *createBlock();
         void appendBlock(Block *blk);
 
+        // Takes ownership of another (block-less) kernel whose memory pool
+        // holds instructions that are used by this kernel's blocks
+        // (e.g. a kernel decoded in chunks on several threads).
+        void adoptMemory(Kernel *k);
+
         // Instruction constructors, the instruction returned must be appended
         // to a block or some other storage
         Instruction *createBasicInstruction(
@@ -105,6 +110,7 @@ namespace iga {
         MemManager                        m_mem;
 
         BlockList                         m_blocks;
+        std::vector<Kernel *>             m_adopted;
     };
 } // namespace
 
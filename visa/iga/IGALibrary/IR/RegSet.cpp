@@ -58,7 +58,7 @@ bool RegSet::setDstRegion(
     RegRef rr,
     Region rgn,
     size_t execSize,
-    size_t typeSizeBits)
+    size_t typeSizeBytes)
 {
     const RegSetInfo *rsi = RegSetInfo::lookup(rn);
     if (!rsi) {
@@ -70,11 +70,11 @@ bool RegSet::setDstRegion(
         hz = 1;
     }
 
-    size_t baseAddr = relativeAddressOf(*rsi, rr, typeSizeBits/8);
+    size_t baseAddr = relativeAddressOf(*rsi, rr, 8*typeSizeBytes);
     bool added = false;
     for (size_t ch = 0; ch < execSize; ch++) {
-        size_t offset = ch*hz*typeSizeBits/8;
-        added |= add(*rsi, baseAddr + offset, typeSizeBits/8);
+        size_t offset = ch*hz*typeSizeBytes;
+        added |= add(*rsi, baseAddr + offset, typeSizeBytes);
     }
     return added;
 }
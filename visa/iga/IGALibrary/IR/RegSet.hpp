@@ -132,7 +132,7 @@ const static RegSetInfo RS_ ## REGSYM = {RegName::REGSYM, REGSYN, REGS, BPR, STA
             RegRef rr,
             Region r,
             size_t execSize,
-            size_t typeSizeBits);
+            size_t typeSizeBytes);
         bool setSrcRegion(
             RegName rn,
             RegRef rr,
@@ -57,6 +57,13 @@ public:
     {
     }
 
+    // allocates from an arena owned elsewhere (e.g. a Kernel's pool),
+    // which must outlive the container
+    explicit std_arena_based_allocator(MemManager *_mem)
+        : MemManager_ptr(_mem, [] (MemManager *) { })
+    {
+    }
+
     explicit std_arena_based_allocator()
         :MemManager_ptr(nullptr)
     {
@@ -426,7 +426,8 @@ public:
         k = nullptr;
         checkForLegacyFields(dopts, errHandler);
         DecoderOpts dopts2(
-            (dopts.formatting_opts & IGA_FORMATTING_OPT_NUMERIC_LABELS) != 0);
+            (dopts.formatting_opts & IGA_FORMATTING_OPT_NUMERIC_LABELS) != 0,
+            (dopts.decoder_opts & IGA_DECODING_OPT_PARALLEL) != 0);
         if ((dopts.decoder_opts & IGA_DECODING_OPT_NATIVE) == 0) {
             if (!iga::ged::IsDecodeSupported(m_model,dopts2)) {
                 return IGA_UNSUPPORTED_PLATFORM;
@@ -473,7 +474,11 @@ public:
                 la = ComputeDepAnalysis(k);
                 fopts.liveAnalysis = &la;
             }
-            FormatKernel(errHandler, ss, fopts, *k, bits);
+            if (dopts.decoder_opts & IGA_DECODING_OPT_PARALLEL) {
+                FormatKernelParallel(errHandler, ss, fopts, *k, bits);
+            } else {
+                FormatKernel(errHandler, ss, fopts, *k, bits);
+            }
 
             // copy the text out
             if (m_disassemble_text) {
@@ -391,6 +391,9 @@ static_assert(sizeof(iga_disassemble_options_t) == 5*4,
 
 /* uses the native decoder for decoding the kernel */
 #define IGA_DECODING_OPT_NATIVE   0x00000001u
+/* decodes and formats large kernels on multiple threads
+ * (only supported by the GED decoder; ignored with a labeler callback) */
+#define IGA_DECODING_OPT_PARALLEL 0x00000002u
 /* just the default decoding opts */
 #define IGA_DECODING_OPTS_DEFAULT \
     (0u)
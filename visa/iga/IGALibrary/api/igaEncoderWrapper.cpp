@@ -2,17 +2,8 @@
 #include "../Backend/GED/Encoder.hpp"
 #include "igaEncoderWrapper.hpp"
 
-iga_status_t KernelEncoder::encode()
+static iga_status_t reportEncodeErrors(const iga::ErrorHandler& errHandler)
 {
-
-    iga::ErrorHandler errHandler;
-    iga::Encoder enc(kernel->getModel(),
-        errHandler, iga::EncoderOpts(autoCompact, true, nocompactFirstEightInst));
-    enc.encodeKernel(
-        *kernel,
-        kernel->getMemManager(),
-        buf,
-        binarySize);
 #ifdef _DEBUG
     if (errHandler.hasErrors()) {
         // failed encode
@@ -35,4 +26,50 @@ iga_status_t KernelEncoder::encode()
     }
 #endif // _DEBUG
     return IGA_SUCCESS;
-}
\ No newline at end of file
+}
+
+iga_status_t KernelEncoder::encode()
+{
+    iga::ErrorHandler errHandler;
+    iga::Encoder enc(kernel->getModel(),
+        errHandler, iga::EncoderOpts(autoCompact, true, nocompactFirstEightInst));
+    enc.encodeKernel(
+        *kernel,
+        kernel->getMemManager(),
+        buf,
+        binarySize);
+    return reportEncodeErrors(errHandler);
+}
+
+StreamEncoder::StreamEncoder(
+    const iga::Model& model, iga::MemManager& mem, size_t maxInsts, bool compact)
+{
+    errHandler = new iga::ErrorHandler();
+    // the encoder lives in the arena that holds the binary; it has virtual
+    // members but no virtual destructor, so it is destroyed explicitly
+    void* storage = mem.alloc(sizeof(iga::Encoder));
+    encoder = ::new (storage) iga::Encoder(model, *errHandler, iga::EncoderOpts(compact, true));
+    encoder->beginStream(mem, maxInsts);
+}
+
+StreamEncoder::~StreamEncoder()
+{
+    encoder->~EncoderBase();
+    delete errHandler;
+}
+
+void StreamEncoder::markBlock(const iga::Block* blk)
+{
+    encoder->markStreamBlock(blk);
+}
+
+void StreamEncoder::encode(iga::Instruction& inst)
+{
+    encoder->encodeStreamInstruction(inst);
+}
+
+iga_status_t StreamEncoder::finish()
+{
+    encoder->endStream(buf, binarySize);
+    return reportEncodeErrors(*errHandler);
+}
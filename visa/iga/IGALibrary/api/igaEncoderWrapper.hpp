@@ -1,6 +1,13 @@
 #include "../IR/Kernel.hpp"
 #include "iga.h"
 
+namespace iga
+{
+    class EncoderBase;
+    typedef EncoderBase Encoder;
+    class ErrorHandler;
+}
+
 // entry point for binary encoding of a IGA IR kernel
 class KernelEncoder
 {
@@ -26,3 +33,33 @@ public:
     void* getBinary() const { return buf; }
     uint32_t getBinarySize() const { return binarySize; }
 };
+
+// entry point for binary encoding of instructions that are not held in a
+// IGA IR kernel: the client encodes them one at a time in layout order,
+// marks where each jump target block starts, and finishes the stream to
+// patch the jump offsets. Branching instructions and blocks must stay alive
+// until finish(); the other instructions may be discarded once encoded.
+class StreamEncoder
+{
+    void* buf = nullptr;
+    uint32_t binarySize = 0;
+    iga::ErrorHandler* errHandler = nullptr;
+    iga::Encoder* encoder = nullptr;
+
+public:
+    // @param mem: holds the binary until the StreamEncoder is destroyed
+    // @param maxInsts: upper bound on the number of instructions encoded
+    // @param compact: auto compact instructions if applicable
+    StreamEncoder(const iga::Model& model, iga::MemManager& mem, size_t maxInsts, bool compact);
+    ~StreamEncoder();
+
+    void markBlock(const iga::Block* blk);
+    void encode(iga::Instruction& inst);
+    iga_status_t finish();
+    void* getBinary() const { return buf; }
+    uint32_t getBinarySize() const { return binarySize; }
+
+private:
+    StreamEncoder(const StreamEncoder&) = delete;
+    StreamEncoder& operator=(const StreamEncoder&) = delete;
+};
@@ -211,6 +211,14 @@ typedef kv_t* (CDECLATTRIBUTE * pIGAKVCreate)(
     iga_status_t *status,
     char *errbuf,
     size_t errbuf_cap);
+#define IGA_KV_CREATE_LAZY_STR "kv_create_lazy"
+typedef kv_t* (CDECLATTRIBUTE * pIGAKVCreateLazy)(
+    iga_gen_t plat,
+    const void *bytes,
+    size_t bytes_len,
+    iga_status_t *status,
+    char *errbuf,
+    size_t errbuf_cap);
 #define IGA_KV_GET_INST_SIZE_STR "kv_get_inst_size"
 typedef int32_t(CDECLATTRIBUTE *pIGAKVGetInstSize)(const kv_t *kv, int32_t pc);
 #define IGA_KV_GET_INST_TARGETS_STR "kv_get_inst_targets"
@@ -399,4 +407,5 @@ typedef struct
     pIGAKVGetFlagSubReg        kv_get_flag_subreg;
     pIGAKVGetPredicate         kv_get_predicate;
     pIGAKVGetIsInversePred     kv_get_inverse_predicate;
+    pIGAKVCreateLazy           kv_create_lazy;
 } kv_functions_t;
@@ -35,6 +35,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../strings.hpp"
 
 #include <sstream>
+#include <vector>
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -56,13 +57,29 @@ public:
     std::map<uint32_t,iga::Instruction*>    m_instsByPc;
     std::map<uint32_t, Block*>              m_blockToPcMap;
 
+    // Lazy views (kv_create_lazy) do not run the decoder up front.
+    // Creation only walks the compaction bits to build a flat index from
+    // PC (in units of a compacted instruction) to instruction ordinal.
+    // Instructions are decoded into m_kernel's memory pool the first time
+    // they are queried, and block starts are computed on the first
+    // kv_is_inst_target call.
+    bool                                    m_lazy;
+    const unsigned char                    *m_bytes;
+    size_t                                  m_bytesLength;
+    std::vector<int32_t>                    m_lazyOrdinalByPc;
+    std::vector<int32_t>                    m_lazyPcs;
+    std::vector<iga::Instruction*>          m_lazyInsts;
+    std::vector<bool>                       m_lazyBlockStarts;
+
     KernelViewImpl(
         iga::Platform platf,
         const void *bytes,
         size_t bytesLength)
         : m_model(*iga::Model::LookupModel(platf))
         , m_kernel(nullptr)
-
+        , m_lazy(false)
+        , m_bytes((const unsigned char *)bytes)
+        , m_bytesLength(bytesLength)
     {
         iga::Decoder decoder(*Model::LookupModel(platf), m_errHandler);
         IGA_ASSERT(Model::LookupModel(platf) != nullptr, "Unsupported platform");
@@ -78,6 +95,41 @@ public:
         }
     }
 
+    // constructs a lazy view; bytes must outlive the view
+    KernelViewImpl(
+        iga::Platform platf,
+        const void *bytes,
+        size_t bytesLength,
+        bool lazy)
+        : m_model(*iga::Model::LookupModel(platf))
+        , m_kernel(new iga::Kernel(m_model))
+        , m_lazy(lazy)
+        , m_bytes((const unsigned char *)bytes)
+        , m_bytesLength(bytesLength)
+    {
+        IGA_ASSERT(lazy, "use the eager constructor");
+        const int32_t len = (int32_t)bytesLength;
+        m_lazyOrdinalByPc.resize((len + 7) / 8, -1);
+        m_lazyPcs.reserve(len / 8);
+        int32_t pc = 0;
+        while (pc + 4 <= len) {
+            int32_t iLen = lazyInstSize(pc);
+            if (pc + iLen > len) {
+                m_errHandler.reportWarning(
+                    pc, "unexpected padding at end of kernel");
+                break;
+            }
+            m_lazyOrdinalByPc[pc / 8] = (int32_t)m_lazyPcs.size();
+            m_lazyPcs.push_back(pc);
+            pc += iLen;
+        }
+        if (pc < len && pc + 4 > len) {
+            m_errHandler.reportWarning(
+                pc, "unexpected padding at end of kernel");
+        }
+        m_lazyInsts.resize(m_lazyPcs.size(), nullptr);
+    }
+
     ~KernelViewImpl() {
         if (m_kernel) {
             delete m_kernel;
@@ -85,7 +137,42 @@ public:
     }
 
 
+    // the size of the instruction at pc from its compaction control bit
+    int32_t lazyInstSize(int32_t pc) const {
+        return DecoderBase::getInstructionSize(m_bytes + pc);
+    }
+
+
+    // returns the instruction ordinal at pc or -1 (lazy views only)
+    int32_t getLazyOrdinal(int32_t pc) const {
+        if (pc < 0 || (pc % 8) != 0 ||
+            pc / 8 >= (int32_t)m_lazyOrdinalByPc.size())
+        {
+            return -1;
+        }
+        return m_lazyOrdinalByPc[pc / 8];
+    }
+
+
+    int32_t getInstSize(int32_t pc) const {
+        if (m_lazy) {
+            if (getLazyOrdinal(pc) < 0) {
+                return 0;
+            }
+            return lazyInstSize(pc);
+        }
+        const iga::Instruction *inst = getInstruction(pc);
+        if (!inst) {
+            return 0;
+        }
+        return inst->hasInstOpt(iga::InstOpt::COMPACTED) ? 8 : 16;
+    }
+
+
     const iga::Instruction *getInstruction(int32_t pc) const {
+        if (m_lazy) {
+            return const_cast<KernelViewImpl *>(this)->decodeLazy(pc);
+        }
         auto itr = m_instsByPc.find(pc);
         if (itr == m_instsByPc.end()) {
             return nullptr;
@@ -94,22 +181,108 @@ public:
     }
 
 
-    const Block *getBlock(int32_t pc) const {
-        auto itr = m_blockToPcMap.find(pc);
-        if (itr == m_blockToPcMap.end()) {
+    // Returns the absolute target PC of a label operand.  Eager views have
+    // labels resolved to blocks; lazy views resolve them to absolute PCs
+    // when the instruction is decoded.
+    int32_t getTargetPc(const iga::Operand &op) const {
+        if (m_lazy) {
+            return op.getImmediateValue().s32;
+        }
+        return op.getTargetBlock()->getPC();
+    }
+
+
+    bool isBlockStart(int32_t pc) const {
+        if (m_lazy) {
+            if (m_lazyBlockStarts.empty()) {
+                const_cast<KernelViewImpl *>(this)->computeLazyBlockStarts();
+            }
+            return getLazyOrdinal(pc) >= 0 && m_lazyBlockStarts[pc / 8];
+        }
+        return m_blockToPcMap.find(pc) != m_blockToPcMap.end();
+    }
+
+private:
+    iga::Instruction *decodeLazy(int32_t pc) {
+        int32_t ordinal = getLazyOrdinal(pc);
+        if (ordinal < 0) {
             return nullptr;
         }
-        return itr->second;
+        iga::Instruction *&inst = m_lazyInsts[ordinal];
+        if (inst) {
+            return inst;
+        }
+        try {
+            iga::Decoder decoder(m_model, m_errHandler);
+            inst = decoder.decodeInstructionAt(
+                *m_kernel, m_bytes, m_bytesLength, pc);
+        } catch (const iga::FatalError &) {
+            // error is already logged
+        }
+        if (!inst) {
+            return nullptr;
+        }
+        inst->setID(ordinal + 1);
+        // the decoder leaves branch targets relative; make them absolute
+        // so that queries and formatting match the eager view's labels
+        if (inst->getOpSpec().isBranching()) {
+            for (unsigned srcIx = 0;
+                srcIx < 2 && srcIx < inst->getSourceCount();
+                srcIx++)
+            {
+                SourceIndex ix = (SourceIndex)srcIx;
+                const Operand &src = inst->getSource(ix);
+                if (src.getKind() != Operand::Kind::LABEL)
+                    continue;
+                int32_t target = src.getImmediateValue().s32;
+                if (inst->getOp() != Op::CALLA)
+                    target += pc;
+                inst->setLabelSource(ix, target, src.getType());
+            }
+        }
+        return inst;
+    }
+
+    // same rules as block inference in the decoder: the kernel start,
+    // the instruction after any branch or EOT, and all branch targets
+    void computeLazyBlockStarts() {
+        m_lazyBlockStarts.resize(m_lazyOrdinalByPc.size() + 1, false);
+        auto markBlock = [&] (int32_t pc) {
+            if (pc >= 0 && pc / 8 < (int32_t)m_lazyBlockStarts.size())
+                m_lazyBlockStarts[pc / 8] = true;
+        };
+        markBlock(0);
+        for (int32_t pc : m_lazyPcs) {
+            const iga::Instruction *inst = decodeLazy(pc);
+            if (!inst) {
+                continue;
+            }
+            int32_t instLen = inst->hasInstOpt(InstOpt::COMPACTED) ? 8 : 16;
+            if (inst->getOpSpec().isBranching()) {
+                markBlock(pc + instLen);
+                for (unsigned srcIx = 0;
+                    srcIx < 2 && srcIx < inst->getSourceCount();
+                    srcIx++)
+                {
+                    const Operand &src = inst->getSource((SourceIndex)srcIx);
+                    if (src.getKind() == Operand::Kind::LABEL)
+                        markBlock(src.getImmediateValue().s32);
+                }
+            } else if (inst->hasInstOpt(InstOpt::EOT)) {
+                markBlock(pc + instLen);
+            }
+        }
     }
 };
 
 // iga.cpp
 extern iga::Platform ToPlatform(iga_gen_t gen);
 
-kv_t *kv_create(
+static kv_t *createKernelView(
     iga_gen_t gen_platf,
     const void *bytes,
     size_t bytes_len,
+    bool lazy,
     iga_status_t *status,
     char *errbuf,
     size_t errbuf_cap)
@@ -129,7 +302,9 @@ kv_t *kv_create(
 
     KernelViewImpl *kvImpl = nullptr;
     try {
-        kvImpl = new (std::nothrow)KernelViewImpl(p, bytes, bytes_len);
+        kvImpl = lazy ?
+            new (std::nothrow)KernelViewImpl(p, bytes, bytes_len, true) :
+            new (std::nothrow)KernelViewImpl(p, bytes, bytes_len);
         if (!kvImpl) {
             if (errbuf)
                 formatTo(errbuf, errbuf_cap, "%s", "failed to allocate");
@@ -186,6 +361,32 @@ kv_t *kv_create(
 }
 
 
+kv_t *kv_create(
+    iga_gen_t gen_platf,
+    const void *bytes,
+    size_t bytes_len,
+    iga_status_t *status,
+    char *errbuf,
+    size_t errbuf_cap)
+{
+    return createKernelView(
+        gen_platf, bytes, bytes_len, false, status, errbuf, errbuf_cap);
+}
+
+
+kv_t *kv_create_lazy(
+    iga_gen_t gen_platf,
+    const void *bytes,
+    size_t bytes_len,
+    iga_status_t *status,
+    char *errbuf,
+    size_t errbuf_cap)
+{
+    return createKernelView(
+        gen_platf, bytes, bytes_len, true, status, errbuf, errbuf_cap);
+}
+
+
 void kv_delete(kv_t *kv)
 {
     if (kv)
@@ -198,11 +399,7 @@ int32_t kv_get_inst_size(const kv_t *kv, int32_t pc)
     if (!kv)
         return 0;
 
-    const iga::Instruction *inst = ((KernelViewImpl *)kv)->getInstruction(pc);
-    if (!inst) {
-        return 0;
-    }
-    return inst->hasInstOpt(iga::InstOpt::COMPACTED) ? 8 : 16;
+    return ((KernelViewImpl *)kv)->getInstSize(pc);
 }
 
 
@@ -214,7 +411,8 @@ uint32_t kv_get_inst_targets(
     if (!kv)
         return 0;
 
-    const Instruction *inst = ((KernelViewImpl *)kv)->getInstruction(pc);
+    const KernelViewImpl *kvImpl = (const KernelViewImpl *)kv;
+    const Instruction *inst = kvImpl->getInstruction(pc);
     if (!inst || inst->getOp() == Op::ILLEGAL) {
         return 0;
     }
@@ -229,7 +427,7 @@ uint32_t kv_get_inst_targets(
         const Operand &op = inst->getSource(SourceIndex::SRC0);
         if (op.getKind() == Operand::Kind::LABEL) {
             if (pcs)
-                pcs[nSrcs] = inst->getJIP()->getPC();
+                pcs[nSrcs] = kvImpl->getTargetPc(op);
             nSrcs++;
         }
     }
@@ -238,7 +436,7 @@ uint32_t kv_get_inst_targets(
         const Operand &op = inst->getSource(SourceIndex::SRC1);
         if (op.getKind() == Operand::Kind::LABEL) {
             if (pcs)
-                pcs[nSrcs] = inst->getUIP()->getPC();
+                pcs[nSrcs] = kvImpl->getTargetPc(op);
             nSrcs++;
         }
     }
@@ -300,7 +498,7 @@ uint32_t kv_is_inst_target(const kv_t *kv, int32_t pc)
 {
     if (!kv)
         return 0;
-    return ((KernelViewImpl *)kv)->getBlock(pc) == nullptr ? 0 : 1;
+    return ((KernelViewImpl *)kv)->isBlockStart(pc) ? 1 : 0;
 }
 
 
@@ -97,6 +97,27 @@ IGA_API kv_t *kv_create(
     char *errbuf,
     size_t errbuf_cap);
 
+/*
+ * Creates a lazy kernel view.  The arguments are the same as kv_create.
+ * Rather than decoding the whole kernel up front, this only indexes the
+ * instruction boundaries; each instruction is decoded the first time it
+ * is queried.  This makes creation cheap for clients that only inspect
+ * some instructions.
+ *
+ * NOTE: the view references 'bytes' rather than copying it; the caller
+ *  must keep the buffer alive until kv_delete.  Decode errors found while
+ *  answering a query are not reported through 'errbuf'; the failing
+ *  instruction is decoded as 'illegal'.  Queries on a lazy view are not
+ *  thread safe.
+ */
+IGA_API kv_t *kv_create_lazy(
+    iga_gen_t plat,
+    const void *bytes,
+    size_t bytes_len,
+    iga_status_t *status,
+    char *errbuf,
+    size_t errbuf_cap);
+
 /* destroys a kernel view */
 IGA_API void kv_delete(kv_t *);
 
@@ -61,16 +61,20 @@ public:
     //
     // This disassembles the kernel and copies out the disassembly log,
     // which may indicate errors or warnings.
+    //
+    // With lazyDecode, instructions are decoded when first queried
+    // (see kv_create_lazy); 'bytes' must then outlive the view.
     KernelView(
         iga_gen_t platf,
         const void *bytes,
         size_t bytesLength,
         char *decodeLog = nullptr,
-        size_t decodeLogLen = 0)
+        size_t decodeLogLen = 0,
+        bool lazyDecode = false)
         : m_kv(nullptr)
         , m_disasm_status(IGA_SUCCESS)
     {
-        m_kv = kv_create(
+        m_kv = (lazyDecode ? kv_create_lazy : kv_create)(
             platf,
             bytes,
             bytesLength,
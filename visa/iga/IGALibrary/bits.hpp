@@ -143,7 +143,7 @@ namespace iga
         // the mask could also be generated, but we expect it to unroll
         int index = 0;
         for (int i = 0, offset = 32;
-            i < sizeof(MASKS)/sizeof(MASKS[0]);
+            i < (int)(sizeof(MASKS)/sizeof(MASKS[0]));
             i++, offset>>=1)
         {
             if (v & MASKS[i]) {
@@ -0,0 +1,95 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+#ifndef COMPILE_TRACE_H
+#define COMPILE_TRACE_H
+
+#include <cstdint>
+#include <string>
+
+// Compile-time tracing shared by IGC and vISA.
+//
+// Spans are appended to a buffer owned by the recording thread, so parallel
+// compiles never contend on a shared lock. A trace session collects every span
+// recorded by any thread between BeginCompileTraceSession and
+// EndCompileTraceSession and writes them as a Chrome trace_event JSON file,
+// which can be loaded into chrome://tracing or Perfetto.
+//
+// Tracing is off by default; when disabled, recording a span costs a single
+// relaxed atomic load.
+
+// Calls nest: tracing stays on until every EnableCompileTrace(true) has been
+// matched by an EnableCompileTrace(false), so concurrent builds can each turn
+// it on for their own session.
+void EnableCompileTrace(bool enable);
+bool IsCompileTraceEnabled();
+
+// Monotonic time in nanoseconds.
+uint64_t GetCompileTraceTime();
+
+// Record a complete span on the calling thread. name is copied.
+void RecordCompileTraceSpan(const char* name, uint64_t beginNS, uint64_t endNS);
+
+// Returns the session start time, or 0 if tracing is disabled.
+uint64_t BeginCompileTraceSession();
+// Writes the spans recorded since sessionStart to fileName and returns false
+// if the file could not be written. Sessions may overlap; each one then also
+// holds the spans of the builds that ran concurrently with it.
+bool EndCompileTraceSession(uint64_t sessionStart, const char* fileName);
+
+// Records a span covering the lifetime of the object.
+class CompileTraceScope
+{
+public:
+    explicit CompileTraceScope(const char* name)
+        : m_begin(IsCompileTraceEnabled() ? GetCompileTraceTime() : 0)
+    {
+        if (m_begin)
+        {
+            m_name = name;
+        }
+    }
+    explicit CompileTraceScope(const std::string& name)
+        : CompileTraceScope(name.c_str())
+    {
+    }
+    ~CompileTraceScope()
+    {
+        if (m_begin)
+        {
+            RecordCompileTraceSpan(m_name.c_str(), m_begin, GetCompileTraceTime());
+        }
+    }
+
+    CompileTraceScope(const CompileTraceScope&) = delete;
+    CompileTraceScope& operator=(const CompileTraceScope&) = delete;
+
+private:
+    uint64_t m_begin;
+    std::string m_name;
+};
+
+#endif // COMPILE_TRACE_H
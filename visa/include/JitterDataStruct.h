@@ -72,6 +72,9 @@ typedef struct _CM_JIT_INFO {
 
     void* freeGRFInfo;
     unsigned int freeGRFInfoSize;
+
+    // max GRF pressure after the pre-RA scheduler, 0 if it did not run
+    unsigned int maxGRFPressure;
 } FINALIZER_INFO;
 
 #define MAX_ERROR_MSG_LEN               511
@@ -50,6 +50,14 @@ struct VISA_StateOpndHandle;
 extern "C" CM_BUILDER_API int CreateVISABuilder(VISABuilder* &builder, vISABuilderMode mode, CM_VISA_BUILDER_OPTION builderOption, TARGET_PLATFORM platform, int numArgs, const char* flags[], PVISA_WA_TABLE pWaTable);
 extern "C" CM_BUILDER_API int DestroyVISABuilder(VISABuilder *&builder);
 
+/**
+ *
+ *  The platform, stepping and current builder are per thread. A thread that
+ *  compiles for a builder created on another thread calls this before it
+ *  uses the builder.
+ */
+extern "C" CM_BUILDER_API int EnterVISABuilderThread(VISABuilder *builder);
+
 /**
  *
  *  Interface for CMRT to free the kernel binary allocated 
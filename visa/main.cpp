@@ -41,6 +41,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Timer.h"
 #include "BinaryEncoding.h"
 #include "JitterDataStruct.h"
+#include "KernelBench.h"
 #ifndef DLL_MODE
 #include "EnumFiles.hpp"
 #endif
@@ -57,6 +58,24 @@ extern bool readIsaBinaryNG(const char *buf, CISA_IR_Builder *builder,
 
 #ifndef DLL_MODE
 void parseWrapper(const char *fileName, int argc, const char *argv[], Options &opt);
+
+// Totals of the microbenchmarks run on the compiled kernels, over all inputs.
+static vISA::KernelBenchResult livenessBench;
+static vISA::KernelBenchResult compactionBench;
+static bool compactionBenchFailed = false;
+
+static void runKernelBenches(CISA_IR_Builder* cisa_builder, Options& opt)
+{
+    if (opt.getuInt32Option(vISA_BenchLiveness) > 0)
+    {
+        vISA::benchLiveness(cisa_builder, opt.getuInt32Option(vISA_BenchLiveness), livenessBench);
+    }
+    if (opt.getuInt32Option(vISA_BenchCompaction) > 0 &&
+        !vISA::benchCompaction(cisa_builder, opt.getuInt32Option(vISA_BenchCompaction), compactionBench))
+    {
+        compactionBenchFailed = true;
+    }
+}
 #endif
 
 // default size of the physical reg pool mem manager in bytes
@@ -177,6 +196,10 @@ void parse(const char *fileName, std::string testName, int argc, const char *arg
     cisa_builder->setTestName(testName);
 
     int result = cisa_builder->Compile((char*)binFileName.c_str());
+    if (result == CM_SUCCESS)
+    {
+        runKernelBenches(cisa_builder, opt);
+    }
     CISA_IR_Builder::DestroyBuilder(cisa_builder);
     if (result != CM_SUCCESS)
     {
@@ -433,6 +456,26 @@ int main( int argc, const char *argv[] )
         }
     }
 
+    if (livenessBench.runs > 0)
+    {
+        uint64_t runs = livenessBench.runs;
+        uint64_t timeNS = livenessBench.timeNS;
+        cout << "liveness: " << runs << " runs, " << (timeNS / 1000) << " us total, " <<
+            (timeNS / runs / 1000.0) << " us/run" << endl;
+    }
+    if (compactionBenchFailed)
+    {
+        cerr << "compaction: results disagree with std::map or with the compiled kernels" << endl;
+        return 1;
+    }
+    if (compactionBench.runs > 0)
+    {
+        uint64_t runs = compactionBench.runs;
+        uint64_t timeNS = compactionBench.timeNS;
+        cout << "compaction: " << runs << " instructions, " << (timeNS / 1000) << " us total, " <<
+            ((double)timeNS / runs) << " ns/instruction" << endl;
+    }
+
 
 #ifdef COLLECT_ALLOCATION_STATS
 #if 0
@@ -442,10 +485,21 @@ int main( int argc, const char *argv[] )
     cout << "total malloc size: " << (totalMallocSize / 1024) << " KB" << endl;
     cout << "# memory managers: " << numMemManagers << endl;
     cout << "Max Arena list length: " << maxArenaLength << endl;
+    cout << "peak arena size: " << (peakMallocSize / 1024) << " KB" << endl;
+    cout << "# arena reuses: " << numArenaReuses << endl;
+    cout << "peak pooled size: " << (peakPooledSize / 1024) << " KB" << endl;
+    cout << "# recycled allocations: " << numRecycledAllocations << endl;
+    cout << "# regions: " << numRegionsCreated << " for " << numRegionLookups << " requests, saved " <<
+        ((numRegionLookups - numRegionsCreated) * sizeof(RegionDesc) / 1024) << " KB" << endl;
+    cout << "# immediates: " << numImmsCreated << " for " << numImmLookups << " lookups, saved " <<
+        ((numImmLookups - numImmsCreated) * sizeof(G4_Imm) / 1024) << " KB" << endl;
 #else
     cout << numAllocations << "\t" << (totalAllocSize / 1024) << "\t" <<
         numMallocCalls << "\t" << (totalMallocSize / 1024) << "\t" << numMemManagers <<
-        "\t" << maxArenaLength << endl;
+        "\t" << maxArenaLength << "\t" << (peakMallocSize / 1024) << "\t" << numArenaReuses <<
+        "\t" << (peakPooledSize / 1024) << "\t" << numRecycledAllocations <<
+        "\t" << numRegionsCreated << "\t" << numRegionLookups <<
+        "\t" << numImmsCreated << "\t" << numImmLookups << endl;
 #endif
 #endif
     return 0;
@@ -580,7 +634,10 @@ void parseWrapper(const char *fileName, int argc, const char *argv[], Options &o
         binFileName = cisaBinaryName;
     }
 
-    cisa_builder->Compile((char *)binFileName.c_str());
+    if (cisa_builder->Compile((char *)binFileName.c_str()) == CM_SUCCESS)
+    {
+        runKernelBenches(cisa_builder, opt);
+    }
     CISA_IR_Builder::DestroyBuilder(cisa_builder);
 }
 #endif
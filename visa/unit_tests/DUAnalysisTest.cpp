@@ -0,0 +1,145 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2018 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+// Checks that UpdateDepAnalysis, after an edit to one block, produces the same
+// dependencies as solving the whole kernel again.
+
+#include "Frontend/KernelParser.hpp"
+#include "IR/DUAnalysis.hpp"
+#include "Models/Models.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+
+using namespace iga;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            std::exit(1); \
+        } \
+    } while (0)
+
+// entry block, a loop, and an exit block that reads values defined in both
+static const char *KERNEL =
+    "        mov (8|M0)               r10.0<1>:d    r1.0<8;8,1>:d\n"
+    "        mov (8|M0)               r20.0<1>:d    r4.0<8;8,1>:d\n"
+    "LOOP:\n"
+    "        add (8|M0)               r10.0<1>:d    r10.0<8;8,1>:d    r2.0<8;8,1>:d\n"
+    "        cmp (8|M0)   (lt)f0.0    null<1>:d     r10.0<8;8,1>:d    r3.0<8;8,1>:d\n"
+    "(W&f0.0) jmpi (1|M0)             LOOP\n"
+    "EXIT:\n"
+    "        mov (8|M0)               r11.0<1>:d    r10.0<8;8,1>:d\n"
+    "        add (8|M0)               r12.0<1>:d    r20.0<8;8,1>:d    r11.0<8;8,1>:d\n"
+    "        nop\n";
+
+// instructions spliced into KERNEL by the tests below
+static const char *DONOR =
+    "        mov (8|M0)               r20.0<1>:d    r10.0<8;8,1>:d\n"
+    "        add (8|M0)               r11.0<1>:d    r20.0<8;8,1>:d    r12.0<8;8,1>:d\n";
+
+static Kernel *parse(const char *text)
+{
+    ErrorHandler eh;
+    Kernel *k = ParseGenKernel(*Model::LookupModel(Platform::GEN9), text, eh);
+    CHECK(k != nullptr && !eh.hasErrors());
+    return k;
+}
+
+static bool sameDeps(const std::vector<Dep> &a, const std::vector<Dep> &b)
+{
+    if (a.size() != b.size())
+        return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i] != b[i])
+            return false;
+    }
+    return true;
+}
+
+static void checkMatchesFullRecompute(Kernel *k, const DepAnalysis &la)
+{
+    DepAnalysis full = ComputeDepAnalysis(k);
+    CHECK(sameDeps(la.deps, full.deps));
+    CHECK(la.blockInfo.size() == full.blockInfo.size());
+    for (size_t i = 0; i < full.blockInfo.size(); i++) {
+        CHECK(la.blockInfo[i].block == full.blockInfo[i].block);
+        CHECK(sameDeps(la.blockInfo[i].liveDefsIn, full.blockInfo[i].liveDefsIn));
+        CHECK(sameDeps(la.blockInfo[i].liveDefsOut, full.blockInfo[i].liveDefsOut));
+    }
+}
+
+// replaces the loop's add with one writing r20, which the exit block reads
+static void testReplaceInLoop()
+{
+    Kernel *k = parse(KERNEL), *donor = parse(DONOR);
+    DepAnalysis la = ComputeDepAnalysis(k, true);
+    std::vector<Dep> depsBefore = la.deps;
+
+    Block *loop = k->getBlockList()[1];
+    Block *spare = donor->getBlockList()[0];
+    std::swap(loop->getInstList()[0], spare->getInstList()[0]);
+
+    UpdateDepAnalysis(la, loop);
+    checkMatchesFullRecompute(k, la);
+    CHECK(!sameDeps(la.deps, depsBefore));
+
+    delete donor;
+    delete k;
+}
+
+// grows the entry block by one instruction, shifting every later instruction
+static void testInsertInEntry()
+{
+    Kernel *k = parse(KERNEL), *donor = parse(DONOR);
+    DepAnalysis la = ComputeDepAnalysis(k, true);
+
+    Block *entry = k->getBlockList()[0];
+    InstList &spare = donor->getBlockList()[0]->getInstList();
+    entry->insertInstBefore(1, spare.back());
+    spare.pop_back();
+
+    UpdateDepAnalysis(la, entry);
+    checkMatchesFullRecompute(k, la);
+
+    // a second edit on the updated analysis, this time in the exit block
+    Block *exit = k->getBlockList()[2];
+    std::swap(exit->getInstList()[0], spare[0]);
+    UpdateDepAnalysis(la, exit);
+    checkMatchesFullRecompute(k, la);
+
+    delete donor;
+    delete k;
+}
+
+int main()
+{
+    testReplaceInLoop();
+    testInsertInEntry();
+    std::printf("DUAnalysisTest: passed\n");
+    return 0;
+}
@@ -0,0 +1,92 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2018 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+// Checks insertion into an IGA block's instruction array and the index map
+// that Block::getInstIndex keeps over it.
+
+#include "IR/Kernel.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+
+using namespace iga;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            std::exit(1); \
+        } \
+    } while (0)
+
+static void checkIndices(const Block *b)
+{
+    const InstList &il = b->getInstList();
+    for (size_t i = 0; i < il.size(); i++) {
+        CHECK(b->getInstIndex(il[i]) == (int)i);
+    }
+}
+
+int main()
+{
+    Kernel k(*Model::LookupModel(Platform::GEN9));
+    Block *b = k.createBlock();
+    k.appendBlock(b);
+
+    Instruction *a = k.createNopInstruction();
+    Instruction *c = k.createNopInstruction();
+    b->appendInstruction(a);
+    b->appendInstruction(c);
+    checkIndices(b);
+
+    // insert in the middle and at both ends with the index map built
+    Instruction *mid = k.createNopInstruction();
+    b->insertInstBefore(1, mid);
+    Instruction *first = k.createNopInstruction();
+    b->insertInstBefore(b->getInstList().begin(), first);
+    Instruction *last = k.createNopInstruction();
+    b->insertInstBefore(b->getInstList().size(), last);
+    CHECK(b->getInstList().size() == 5);
+    CHECK(b->getInstList()[0] == first && b->getInstList()[2] == mid);
+    CHECK(b->getInstIndex(last) == 4);
+    checkIndices(b);
+
+    // edits made directly on the array are picked up on the next lookup
+    InstList &il = b->getInstList();
+    il.erase(il.begin());
+    CHECK(b->getInstIndex(first) == -1);
+    CHECK(b->getInstIndex(a) == 0);
+    checkIndices(b);
+
+    // appends keep a built index map current while the array grows
+    for (int i = 0; i < 1000; i++) {
+        b->appendInstruction(k.createNopInstruction());
+    }
+    checkIndices(b);
+
+    std::printf("IGABlockTest: passed\n");
+    return 0;
+}
@@ -0,0 +1,126 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2018 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+// Checks the sparse interference rows that global RA uses for kernels too large
+// for the dense matrix, in particular the queries that fall outside the
+// columns a bit row covers.
+
+#include "GraphColor.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+using namespace vISA;
+
+// SparseIntfRow is header only; define the mask table from GraphColor.cpp here
+// instead of linking the whole jitter
+unsigned int BitMask[BITS_DWORD] =
+{
+    0x00000001, 0x00000002, 0x00000004, 0x00000008,
+    0x00000010, 0x00000020, 0x00000040, 0x00000080,
+    0x00000100, 0x00000200, 0x00000400, 0x00000800,
+    0x00001000, 0x00002000, 0x00004000, 0x00008000,
+    0x00010000, 0x00020000, 0x00040000, 0x00080000,
+    0x00100000, 0x00200000, 0x00400000, 0x00800000,
+    0x01000000, 0x02000000, 0x04000000, 0x08000000,
+    0x10000000, 0x20000000, 0x40000000, 0x80000000
+};
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            std::exit(1); \
+        } \
+    } while (0)
+
+static void testIdRow()
+{
+    SparseIntfRow row;
+    row.init(40, 4);
+    row.insert(90);
+    row.insert(45);
+    row.insert(90);
+    CHECK(!row.usesBits());
+    CHECK(row.contains(45));
+    CHECK(row.contains(90));
+    CHECK(!row.contains(40));
+    CHECK(!row.contains(0));
+    CHECK(!row.contains(46));
+}
+
+static void testBitRowSelfQuery()
+{
+    // (rowId + 1) % BITS_DWORD == 0, so the first bit word starts right
+    // after rowId and rowId itself maps to the word before it
+    const uint32_t rowId = 2 * BITS_DWORD - 1;
+    const uint32_t rowSize = 4;
+    SparseIntfRow row;
+    row.init(rowId, rowSize);
+    for (uint32_t v = rowId + 1; v < rowSize * BITS_DWORD; v += 3)
+    {
+        row.insert(v);
+    }
+    CHECK(row.usesBits());
+
+    CHECK(!row.contains(rowId));
+    CHECK(!row.contains(0));
+    CHECK(!row.contains(BITS_DWORD));
+    CHECK(row.contains(rowId + 1));
+    CHECK(!row.contains(rowId + 2));
+    CHECK(row.contains(rowId + 4));
+    CHECK(!row.contains(rowSize * BITS_DWORD));
+}
+
+static void testBitRowBelowRowId()
+{
+    // rowId in the middle of a word: the first bit word also covers ids <= rowId
+    const uint32_t rowId = BITS_DWORD + 5;
+    SparseIntfRow row;
+    row.init(rowId, 2);
+    for (uint32_t v = rowId + 1; v < 2 * BITS_DWORD; ++v)
+    {
+        row.insert(v);
+    }
+    CHECK(row.usesBits());
+    for (uint32_t v = 0; v <= rowId; ++v)
+    {
+        CHECK(!row.contains(v));
+    }
+    for (uint32_t v = rowId + 1; v < 2 * BITS_DWORD; ++v)
+    {
+        CHECK(row.contains(v));
+    }
+}
+
+int main()
+{
+    testIdRow();
+    testBitRowSelfQuery();
+    testBitRowBelowRowId();
+    std::printf("SparseIntfRowTest: passed\n");
+    return 0;
+}
@@ -61,3 +61,16 @@ CM_BUILDER_API int DestroyVISABuilder(VISABuilder *&builder)
     int status = CISA_IR_Builder::DestroyBuilder(cisa_builder);
     return status;
 }
+
+extern "C"
+CM_BUILDER_API int EnterVISABuilderThread(VISABuilder *builder)
+{
+    CISA_IR_Builder *cisa_builder = (CISA_IR_Builder *) builder;
+    if( cisa_builder == NULL )
+    {
+        return CM_FAILURE;
+    }
+
+    cisa_builder->enterThread();
+    return CM_SUCCESS;
+}